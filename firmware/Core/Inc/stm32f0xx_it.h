@@ -52,6 +52,14 @@ void SVC_Handler(void);
 void PendSV_Handler(void);
 void SysTick_Handler(void);
 /* USER CODE BEGIN EFP */
+void EXTI0_1_IRQHandler(void);
+void EXTI2_3_IRQHandler(void);
+void EXTI4_15_IRQHandler(void);
+void DMA1_Channel2_3_IRQHandler(void);
+void SPI1_IRQHandler(void);
+void I2C1_IRQHandler(void);
+void DMA1_Channel4_5_IRQHandler(void);
+void USART2_IRQHandler(void);
 
 /* USER CODE END EFP */
 
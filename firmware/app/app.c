@@ -10,20 +10,30 @@
 
 #include <stdbool.h>
 #include <stdlib.h>
-#include <stdio.h>
+#include <string.h>
 
 #include "main.h"
+#include "clock.h"
+#include "game.h"
+#include "input.h"
+#include "mirror.h"
+#include "power.h"
+#include "profile.h"
+#include "remote.h"
+#include "scheduler.h"
 #include "max7219.h"
 #include "tictactoe.h"
 #include "snake.h"
 #include "drawing.h"
 #include "ssd1306.h"
-
-#define BUTTON_DEBOUNCE_DELAY_MS 10
+#include "storage.h"
+#include "telemetry.h"
 
 #define GAME_OPTIONS_PER_SCREEN 3
 
-extern SPI_HandleTypeDef hspi1;
+extern SPI_HandleTypeDef  hspi1;
+extern I2C_HandleTypeDef  hi2c1;
+extern UART_HandleTypeDef huart2;
 
 typedef enum {
     SNAKE     = 0,
@@ -32,86 +42,168 @@ typedef enum {
     GAME_AMOUNT, // Keep at end!
 } game_id_t;
 
-typedef struct {
-    game_id_t   id;
-    const char* name;
-    void (*run)(void);
-} game_t;
-
 /* clang-format off */
 
-static game_t games[] = {
-    [SNAKE]     = { .id = SNAKE,     .name = "Snake",     .run = snake     },
-    [TICTACTOE] = { .id = TICTACTOE, .name = "TicTacToe", .run = tictactoe },
-	[DRAWING] 	= { .id = DRAWING,   .name = "Drawing",   .run = drawing   },
+static const game_t* const games[GAME_AMOUNT] = {
+    [SNAKE]     = &snake_game,
+    [TICTACTOE] = &tictactoe_game,
+    [DRAWING]   = &drawing_game,
 };
 
 /* clang-format on */
 
-bool      matrix[MAX7219_COLUMN_AMOUNT][MAX7219_ROW_AMOUNT] = { false };
-max7219_t max7219                                           = { 0 };
+typedef struct {
+    const game_t* game;
+    void*         state;
+    uint32_t      report_elapsed_ms; // Since the last telemetry report
+} game_session_t;
+
+static scheduler_t game_scheduler;
+static uint32_t    game_arena[(GAME_ARENA_SIZE + sizeof(uint32_t) - 1) / sizeof(uint32_t)]; // Word aligned, owned by the running game
+
+max7219_fb_t matrix  = { 0 };
+max7219_t    max7219 = { 0 };
+
+// Buzzer, switched off by app_beep_tick() (SysTick)
+static volatile bool     beep_active      = false;
+static volatile uint32_t beep_start_ms    = 0;
+static volatile uint16_t beep_duration_ms = 0;
 
-void app_matrix_clean(bool matrix[MAX7219_COLUMN_AMOUNT][MAX7219_ROW_AMOUNT])
+void app_matrix_clean(max7219_fb_t* matrix)
 {
-    for (uint8_t i = 0; i < MAX7219_COLUMN_AMOUNT; i++) {
-        for (uint8_t j = 0; j < MAX7219_ROW_AMOUNT; j++) {
-            matrix[i][j] = false;
+    max7219_fb_clear(matrix);
+}
+
+button_t app_get_user_input(void)
+{
+    input_event_t event;
+
+    // Releases are dropped, the first queued press is returned. Further presses stay queued for the next call.
+    while (input_get_event(&event)) {
+        REMOTE_INPUT_CONSUMED(&event);
+
+        if (event.pressed) {
+            return event.button;
         }
     }
+
+    return BUTTON_NONE;
 }
 
-button_t app_get_user_input(void)
+button_t app_wait_for_user_input(void)
 {
-    static bool button_up_previous     = 0;
-    static bool button_down_previous   = 0;
-    static bool button_left_previous   = 0;
-    static bool button_right_previous  = 0;
-    static bool button_center_previous = 0;
+    button_t button;
 
-    button_t button = BUTTON_NONE;
+    while ((button = app_get_user_input()) == BUTTON_NONE) {
+        SSD1306_UpdatePending(); // Nothing is drawn while waiting
+        MIRROR_UPDATE(&matrix);
+        power_idle();
+    }
 
-    bool button_up_current     = HAL_GPIO_ReadPin(BUTTON_UP_GPIO_Port, BUTTON_UP_Pin);
-    bool button_down_current   = HAL_GPIO_ReadPin(BUTTON_DOWN_GPIO_Port, BUTTON_DOWN_Pin);
-    bool button_left_current   = HAL_GPIO_ReadPin(BUTTON_LEFT_GPIO_Port, BUTTON_LEFT_Pin);
-    bool button_right_current  = HAL_GPIO_ReadPin(BUTTON_RIGHT_GPIO_Port, BUTTON_RIGHT_Pin);
-    bool button_center_current = HAL_GPIO_ReadPin(BUTTON_CENTER_GPIO_Port, BUTTON_CENTER_Pin);
+    return button;
+}
 
-    if (button_up_current && !button_up_previous) {
-        button = BUTTON_UP;
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+    input_exti_callback(GPIO_Pin);
+}
+
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef* hspi)
+{
+    if (hspi == max7219.spi) {
+        max7219_spi_tx_complete(&max7219);
+    }
+}
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef* hspi)
+{
+    if (hspi == max7219.spi) {
+        max7219_spi_error(&max7219);
+        telemetry_error(TELEMETRY_SOURCE_MAX7219, MAX7219_COM_ERROR);
     }
+}
 
-    if (button_down_current && !button_down_previous) {
-        button = BUTTON_DOWN;
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef* hi2c)
+{
+    if (hi2c == &hi2c1) {
+        SSD1306_I2C_TxCpltCallback();
     }
+}
 
-    if (button_left_current && !button_left_previous) {
-        button = BUTTON_LEFT;
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef* hi2c)
+{
+    if (hi2c == &hi2c1) {
+        SSD1306_I2C_ErrorCallback();
+        telemetry_error(TELEMETRY_SOURCE_SSD1306, 1);
     }
+}
 
-    if (button_right_current && !button_right_previous) {
-        button = BUTTON_RIGHT;
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart)
+{
+    if (huart == &huart2) {
+        telemetry_uart_tx_complete();
     }
+}
 
-    if (button_center_current && !button_center_previous) {
-        button = BUTTON_CENTER;
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef* huart)
+{
+    if (huart == &huart2) {
+        REMOTE_UART_RX_COMPLETE();
     }
+}
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef* huart)
+{
+    if (huart == &huart2) {
+        // RX errors (remote control) must not skip a telemetry chunk
+        if ((HAL_UART_GetError(huart) & HAL_UART_ERROR_DMA) != 0) {
+            telemetry_uart_error();
+        }
 
-    button_up_previous     = button_up_current;
-    button_down_previous   = button_down_current;
-    button_left_previous   = button_left_current;
-    button_right_previous  = button_right_current;
-    button_center_previous = button_center_current;
+        REMOTE_UART_ERROR();
+    }
+}
 
-    HAL_Delay(BUTTON_DEBOUNCE_DELAY_MS);
+/**
+ * @brief Report an unrecoverable error and halt (the telemetry is still sent by the interrupts)
+ *
+ * @param[in] source -- Module which failed
+ * @param[in] code   -- Error code of the module
+ */
+static void fatal_error(telemetry_source_t source, uint8_t code)
+{
+    telemetry_error(source, code);
 
-    return button;
+    for (;;) {
+        __WFI();
+    } // Error handling...
 }
 
 void app_beep(uint16_t duration_ms)
 {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    // A running beep is extended
+    beep_start_ms    = HAL_GetTick();
+    beep_duration_ms = duration_ms;
+    beep_active      = true;
     HAL_GPIO_WritePin(BUZZER_GPIO_Port, BUZZER_Pin, GPIO_PIN_SET);
-    HAL_Delay(duration_ms);
-    HAL_GPIO_WritePin(BUZZER_GPIO_Port, BUZZER_Pin, GPIO_PIN_RESET);
+
+    __set_PRIMASK(primask);
+}
+
+bool app_beep_is_active(void)
+{
+    return beep_active;
+}
+
+void app_beep_tick(void)
+{
+    if (beep_active && ((HAL_GetTick() - beep_start_ms) >= beep_duration_ms)) {
+        beep_active = false;
+        HAL_GPIO_WritePin(BUZZER_GPIO_Port, BUZZER_Pin, GPIO_PIN_RESET);
+    }
 }
 
 void app_lcd_print_title(void)
@@ -157,10 +249,11 @@ static void lcd_print_game_selection(game_id_t game_id)
         }
 
         SSD1306_GotoXY(APP_LCD_COL_GAME_SELECTION_INDENTATION, APP_LCD_ROW_GAME_NAME + (i * APP_LCD_ROW_GAME_DIFFERENCE));
-        SSD1306_Puts(games[start_id + i].name, &Font_7x10, 1);
+        SSD1306_Puts(games[start_id + i]->name, &Font_7x10, 1);
     }
 
-    SSD1306_UpdateScreen();
+    SSD1306_UpdateScreenAsync();
+    REMOTE_FRAME_DONE();
 
     start_id_previous = start_id;
 }
@@ -175,9 +268,7 @@ static game_id_t select_game(void)
     lcd_print_game_selection(game_id);
 
     do {
-        do {
-            button = app_get_user_input();
-        } while (button == BUTTON_NONE);
+        button = app_wait_for_user_input();
 
         if (button == BUTTON_DOWN) {
             if (game_id < (GAME_AMOUNT - 1)) {
@@ -199,29 +290,142 @@ static game_id_t select_game(void)
     return game_id;
 }
 
+static void game_loop_update(void* context)
+{
+    game_session_t* session = context;
+    input_event_t   events[GAME_EVENT_AMOUNT];
+    uint8_t         event_amount = 0;
+
+    while ((event_amount < GAME_EVENT_AMOUNT) && input_get_event(&events[event_amount])) {
+        REMOTE_INPUT_CONSUMED(&events[event_amount]);
+        ++event_amount;
+    }
+
+    PROFILE_BEGIN(PROFILE_SCOPE_GAME_UPDATE);
+    game_status_t status = session->game->update(session->state, GAME_FRAME_PERIOD_MS, events, event_amount);
+    PROFILE_END(PROFILE_SCOPE_GAME_UPDATE);
+
+    if (status == GAME_EXIT) {
+        scheduler_stop(&game_scheduler);
+    }
+
+    session->report_elapsed_ms += GAME_FRAME_PERIOD_MS;
+
+    if (session->report_elapsed_ms >= TELEMETRY_REPORT_PERIOD_MS) {
+        session->report_elapsed_ms = 0;
+        telemetry_report(scheduler_get_stats(&game_scheduler));
+    }
+}
+
+static void game_loop_render(void* context)
+{
+    game_session_t* session = context;
+
+    app_matrix_clean(&matrix);
+    PROFILE_BEGIN(PROFILE_SCOPE_GAME_RENDER);
+    session->game->render(session->state, &matrix);
+    PROFILE_END(PROFILE_SCOPE_GAME_RENDER);
+
+    // The framebuffer is copied, the next render may start right away. While the previous frame is still shifting out,
+    // this one is skipped; the next render pushes the latest state.
+    PROFILE_BEGIN(PROFILE_SCOPE_MATRIX_PUSH);
+    max7219_error_t error = max7219_set_matrix_async(&max7219, &matrix, NULL);
+    PROFILE_END(PROFILE_SCOPE_MATRIX_PUSH);
+
+    if ((error != MAX7219_OK) && (error != MAX7219_BUSY) && (error != MAX7219_UNCHANGED)) {
+        fatal_error(TELEMETRY_SOURCE_MAX7219, error);
+    }
+
+    PROFILE_BEGIN(PROFILE_SCOPE_OLED_UPDATE_ASYNC);
+    SSD1306_UpdateScreenAsync();
+    PROFILE_END(PROFILE_SCOPE_OLED_UPDATE_ASYNC);
+
+    REMOTE_FRAME_DONE();
+    MIRROR_UPDATE(&matrix);
+}
+
+/**
+ * @brief Run a game plug-in until it exits
+ *
+ * @param[in] game_id
+ */
+static void run_game(game_id_t game_id)
+{
+    const game_t*  game    = games[game_id];
+    game_session_t session = {
+        .game              = game,
+        .state             = game_arena,
+        .report_elapsed_ms = 0,
+    };
+
+    telemetry_event(TELEMETRY_EVENT_GAME_START, game_id);
+
+    memset(game_arena, 0, game->state_size); // Fits, checked at compile time by every game
+
+    game->init(session.state);
+    input_flush(); // The press which selected the game is not part of it
+
+    game_loop_render(&session);
+
+    scheduler_init(&game_scheduler, GAME_FRAME_PERIOD_MS, game_loop_update, game_loop_render, &session);
+    scheduler_run(&game_scheduler);
+
+    if (game->exit != NULL) {
+        game->exit(session.state);
+    }
+
+    telemetry_event(TELEMETRY_EVENT_GAME_EXIT, game_id);
+}
+
 void app(void)
 {
-    game_id_t game_id;
+    game_id_t       game_id;
+    clock_error_t   clock_error;
+    max7219_error_t max7219_error;
+    storage_error_t storage_error;
+
+    PROFILE_INIT(); // Before clock_init(), which adapts the prescaler
 
-    if (max7219_init(&max7219, &hspi1, MAX_SPI_CS_GPIO_Port, MAX_SPI_CS_Pin) != MAX7219_OK) {
-        for (;;) {
-        } // Error handling...
+    clock_error = clock_init(CLOCK_PROFILE_LOW_POWER);
+
+    telemetry_init(&huart2); // After clock_init(), which sets the baud rate
+    REMOTE_INIT(&huart2);
+
+    if (clock_error != CLOCK_OK) {
+        fatal_error(TELEMETRY_SOURCE_CLOCK, clock_error);
+    }
+
+    max7219_error = max7219_init(&max7219, &hspi1, MAX_SPI_CS_GPIO_Port, MAX_SPI_CS_Pin);
+
+    if (max7219_error != MAX7219_OK) {
+        fatal_error(TELEMETRY_SOURCE_MAX7219, max7219_error);
     }
 
     SSD1306_Init();
 
+    input_init();
+
+    storage_error = storage_init();
+
+    if (storage_error != STORAGE_OK) {
+        telemetry_error(TELEMETRY_SOURCE_STORAGE, storage_error); // The games run without persistent data
+    }
+
+    power_init();
+
     for (;;) {
-        app_matrix_clean(matrix);
+        app_matrix_clean(&matrix);
 
-        if (max7219_set_matrix(&max7219, matrix) != MAX7219_OK) {
-            for (;;) {
-            } // Error handling...
+        max7219_error = max7219_set_matrix(&max7219, &matrix);
+
+        if (max7219_error != MAX7219_OK) {
+            fatal_error(TELEMETRY_SOURCE_MAX7219, max7219_error);
         }
 
         game_id = select_game();
 
-        if (games[game_id].run != NULL) {
-            games[game_id].run();
-        }
+        max7219_reset_stats(&max7219); // Measure the SPI traffic per game
+
+        run_game(game_id);
     }
 }
@@ -12,6 +12,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "input.h"
 #include "max7219.h"
 
 #define APP_LCD_TITLE            "GWF Schnupperlehre"
@@ -31,22 +32,16 @@
 #define BEEP_SHORT_MS 75
 #define BEEP_LONG_MS  750
 
-typedef enum button {
-    BUTTON_UP,
-    BUTTON_DOWN,
-    BUTTON_LEFT,
-    BUTTON_RIGHT,
-    BUTTON_CENTER,
-    BUTTON_NONE,
-} button_t;
-
-extern bool      matrix[MAX7219_COLUMN_AMOUNT][MAX7219_ROW_AMOUNT];
-extern max7219_t max7219;
+extern max7219_fb_t matrix;
+extern max7219_t    max7219;
 
 void     app(void);
-void     app_beep(uint16_t duration_ms);
+void     app_beep(uint16_t duration_ms); // Returns at once, the buzzer is switched off by app_beep_tick()
+bool     app_beep_is_active(void);
+void     app_beep_tick(void); // To be called from the 1 ms SysTick interrupt
 button_t app_get_user_input(void);
-void     app_matrix_clean(bool matrix[MAX7219_COLUMN_AMOUNT][MAX7219_ROW_AMOUNT]);
+button_t app_wait_for_user_input(void);
+void     app_matrix_clean(max7219_fb_t* matrix);
 void     app_lcd_print_title(void);
 
 #endif /* APP_H_ */
@@ -0,0 +1,197 @@
+/**
+ * @file clock.c
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ * SystemClock_Config() (CubeMX) sets up the 8 MHz HSI profile. The performance profile switches SYSCLK to the HSI48
+ * oscillator. HAL_RCC_ClockConfig() takes care of the flash wait states and of the SysTick reload.
+ */
+
+#include "clock.h"
+
+#include <stdbool.h>
+
+#include "app.h"
+#include "main.h"
+#include "power.h"
+#include "profile.h"
+#include "remote.h"
+#include "ssd1306.h"
+#include "telemetry.h"
+
+extern SPI_HandleTypeDef  hspi1;
+extern UART_HandleTypeDef huart2;
+
+static clock_profile_t base_profile   = CLOCK_PROFILE_LOW_POWER;
+static clock_profile_t active_profile = CLOCK_PROFILE_LOW_POWER;
+static uint8_t         boost_depth    = 0;
+
+static clock_error_t configure_sysclk(clock_profile_t profile)
+{
+    RCC_OscInitTypeDef RCC_OscInitStruct = { 0 };
+    RCC_ClkInitTypeDef RCC_ClkInitStruct = { 0 };
+
+    RCC_ClkInitStruct.ClockType      = RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_PCLK1;
+    RCC_ClkInitStruct.AHBCLKDivider  = RCC_SYSCLK_DIV1;
+    RCC_ClkInitStruct.APB1CLKDivider = RCC_HCLK_DIV1;
+
+    if (profile == CLOCK_PROFILE_PERFORMANCE) {
+        RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_HSI48;
+        RCC_OscInitStruct.HSI48State     = RCC_HSI48_ON;
+        RCC_OscInitStruct.PLL.PLLState   = RCC_PLL_NONE;
+
+        if (HAL_RCC_OscConfig(&RCC_OscInitStruct) != HAL_OK) {
+            return CLOCK_ERROR;
+        }
+
+        __HAL_FLASH_PREFETCH_BUFFER_ENABLE();
+
+        RCC_ClkInitStruct.SYSCLKSource = RCC_SYSCLKSOURCE_HSI48;
+
+        if (HAL_RCC_ClockConfig(&RCC_ClkInitStruct, FLASH_LATENCY_1) != HAL_OK) {
+            return CLOCK_ERROR;
+        }
+    } else {
+        RCC_ClkInitStruct.SYSCLKSource = RCC_SYSCLKSOURCE_HSI;
+
+        if (HAL_RCC_ClockConfig(&RCC_ClkInitStruct, FLASH_LATENCY_0) != HAL_OK) {
+            return CLOCK_ERROR;
+        }
+
+        // HSI48 is not needed anymore
+        RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_HSI48;
+        RCC_OscInitStruct.HSI48State     = RCC_HSI48_OFF;
+        RCC_OscInitStruct.PLL.PLLState   = RCC_PLL_NONE;
+
+        if (HAL_RCC_OscConfig(&RCC_OscInitStruct) != HAL_OK) {
+            return CLOCK_ERROR;
+        }
+    }
+
+    return CLOCK_OK;
+}
+
+/**
+ * @brief USART2 baud rate, follows the base profile so a boost does not change the baud rate the host has to use
+ */
+static uint32_t uart_baud_rate(void)
+{
+    return (base_profile == CLOCK_PROFILE_PERFORMANCE) ? CLOCK_UART_BAUD_PERFORMANCE : CLOCK_UART_BAUD_LOW_POWER;
+}
+
+static clock_error_t configure_peripherals(void)
+{
+    uint32_t pclk      = HAL_RCC_GetPCLK1Freq();
+    uint32_t prescaler = SPI_BAUDRATEPRESCALER_2;
+    uint32_t divider   = 2;
+
+    // Smallest prescaler which keeps SCK within the MAX7219 limit
+    while (((pclk / divider) > CLOCK_SPI_MAX_HZ) && (prescaler < SPI_BAUDRATEPRESCALER_256)) {
+        prescaler += SPI_CR1_BR_0;
+        divider *= 2;
+    }
+
+    hspi1.Init.BaudRatePrescaler = prescaler;
+
+    if (HAL_SPI_Init(&hspi1) != HAL_OK) {
+        return CLOCK_ERROR;
+    }
+
+    // USART2 is clocked from PCLK, the baud rate register has to be recomputed
+    huart2.Init.BaudRate = uart_baud_rate();
+
+    if (HAL_UART_Init(&huart2) != HAL_OK) {
+        return CLOCK_ERROR;
+    }
+
+    PROFILE_CLOCK_CHANGED();
+
+    return CLOCK_OK;
+}
+
+static clock_error_t apply_profile(clock_profile_t profile)
+{
+    clock_error_t error;
+
+    if (uart_baud_rate() != huart2.Init.BaudRate) {
+        // Announced at the old baud rate, everything queued so far has to get out before switching
+        telemetry_baud(uart_baud_rate());
+
+        while (!telemetry_is_empty()) {
+            power_sleep();
+        }
+    }
+
+    telemetry_pause(); // Otherwise only the running chunk has to finish, the rest stays queued
+    REMOTE_PAUSE();
+
+    // The peripherals must not be reconfigured in the middle of a transfer
+    while (max7219_is_busy(&max7219) || SSD1306_IsBusy() || telemetry_is_busy()) {
+        power_sleep();
+    }
+
+    error = configure_sysclk(profile);
+
+    if (error == CLOCK_OK) {
+        active_profile = profile;
+        error          = configure_peripherals();
+    }
+
+    telemetry_resume();
+    REMOTE_RESUME();
+
+    return error;
+}
+
+clock_error_t clock_init(clock_profile_t profile)
+{
+    boost_depth = 0;
+
+    return clock_set_profile(profile);
+}
+
+clock_error_t clock_set_profile(clock_profile_t profile)
+{
+    base_profile = profile;
+
+    if (boost_depth > 0) {
+        return CLOCK_OK; // Applied with the last clock_boost_end()
+    }
+
+    return apply_profile(profile);
+}
+
+clock_profile_t clock_get_profile(void)
+{
+    return active_profile;
+}
+
+void clock_boost_begin(void)
+{
+    if ((boost_depth++ == 0) && (base_profile != CLOCK_PROFILE_PERFORMANCE)) {
+        apply_profile(CLOCK_PROFILE_PERFORMANCE);
+    }
+}
+
+void clock_boost_end(void)
+{
+    if (boost_depth == 0) {
+        return; // Unbalanced call
+    }
+
+    if ((--boost_depth == 0) && ((active_profile != base_profile) || (huart2.Init.BaudRate != uart_baud_rate()))) {
+        apply_profile(base_profile);
+    }
+}
+
+void clock_restore(void)
+{
+    SystemClock_Config(); // CLOCK_PROFILE_LOW_POWER
+
+    if (active_profile != CLOCK_PROFILE_LOW_POWER) {
+        configure_sysclk(active_profile);
+    }
+
+    configure_peripherals();
+}
@@ -0,0 +1,76 @@
+/**
+ * @file clock.h
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ */
+
+#ifndef CLOCK_H_
+#define CLOCK_H_
+
+#include <stdint.h>
+
+#define CLOCK_SPI_MAX_HZ 10000000 // MAX7219 max. serial clock [Hz]
+
+#define CLOCK_UART_BAUD_LOW_POWER   115200 // USART2 (telemetry) with CLOCK_PROFILE_LOW_POWER as base profile
+#define CLOCK_UART_BAUD_PERFORMANCE 921600 // USART2 (telemetry) with CLOCK_PROFILE_PERFORMANCE as base profile
+
+typedef enum {
+    CLOCK_PROFILE_LOW_POWER,   // 8 MHz HSI, no wait state
+    CLOCK_PROFILE_PERFORMANCE, // 48 MHz HSI48, 1 wait state, prefetch enabled
+} clock_profile_t;
+
+typedef enum {
+    CLOCK_OK,
+    CLOCK_ERROR,
+} clock_error_t;
+
+/**
+ * @brief Initialize the clock management with a base profile
+ *
+ * @param[in] profile -- Profile used while no boost is active
+ *
+ * @return clock_error_t -- Error code
+ */
+clock_error_t clock_init(clock_profile_t profile);
+
+/**
+ * @brief Change the base profile (used while no boost is active)
+ *
+ * Waits for pending SPI/I2C/UART transfers, switches SYSCLK and recomputes the SPI1 prescaler and the USART2 baud rate
+ * register. I2C1 is clocked from HSI in every profile, so its timing does not change. The USART2 baud rate follows the
+ * base profile (boosts keep it), a change is announced over the telemetry first.
+ *
+ * @param[in] profile -- Profile
+ *
+ * @return clock_error_t -- Error code
+ */
+clock_error_t clock_set_profile(clock_profile_t profile);
+
+/**
+ * @brief Get the active profile
+ *
+ * @return clock_profile_t -- Profile
+ */
+clock_profile_t clock_get_profile(void);
+
+/**
+ * @brief Run at CLOCK_PROFILE_PERFORMANCE until the matching clock_boost_end() (calls may be nested)
+ *
+ * Each switch waits for idle peripherals, re-initializes SPI1 and USART2 and pauses the telemetry and the remote
+ * control, so only boost CPU bound work of several milliseconds (not bus transfers, which do not get faster).
+ */
+void clock_boost_begin(void);
+
+/**
+ * @brief End a boost; the base profile is restored after the outermost call
+ */
+void clock_boost_end(void);
+
+/**
+ * @brief Re-apply the active profile after the clock tree was reset (e.g., wake-up from stop mode)
+ */
+void clock_restore(void);
+
+#endif /* CLOCK_H_ */
@@ -0,0 +1,80 @@
+/**
+ * @file game.h
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ */
+
+#ifndef GAME_H_
+#define GAME_H_
+
+#include <stdint.h>
+
+#include "input.h"
+#include "max7219.h"
+
+#define GAME_FRAME_PERIOD_MS 20                 // Period of the shared game loop (update + render) [ms]
+#define GAME_EVENT_AMOUNT    INPUT_QUEUE_LENGTH // Max. input events passed to one update
+
+#ifndef GAME_ARENA_SIZE
+#define GAME_ARENA_SIZE 128 // State arena shared by all games, only the running game owns it [bytes]
+#endif
+
+/**
+ * @brief Compile-time check that a game state fits into the arena (put it next to the state type)
+ */
+#define GAME_STATE_ASSERT(type)                                                                                        \
+    _Static_assert(sizeof(type) <= GAME_ARENA_SIZE, #type " does not fit into GAME_ARENA_SIZE");                       \
+    _Static_assert(_Alignof(type) <= _Alignof(uint32_t), #type " needs a stronger alignment than the arena")
+
+/**
+ * @brief Return value of the update hook
+ */
+typedef enum {
+    GAME_CONTINUE,
+    GAME_EXIT, // Back to the game selection
+} game_status_t;
+
+/**
+ * @brief Game plug-in
+ *
+ * Games keep no static data, their state lives in the arena of the app shell (see GAME_STATE_ASSERT()). The shell
+ * zeroes state_size bytes of the arena, calls init() once, then update() and render() every
+ * GAME_FRAME_PERIOD_MS until update() returns GAME_EXIT, and finally exit(). The shell pushes the framebuffer to the
+ * matrix and the OLED buffer to the display after every render() and sleeps in between, so games never block
+ * (app_beep() only switches the buzzer on).
+ */
+typedef struct {
+    const char* name;
+    uint16_t    state_size; // [bytes]
+
+    /**
+     * @brief Initialize the state and draw the start screen on the OLED
+     */
+    void (*init)(void* state);
+
+    /**
+     * @brief Advance the game by dt_ms
+     *
+     * @param[in,out] state        -- Game state
+     * @param[in]     dt_ms        -- Elapsed time since the last update [ms]
+     * @param[in]     events       -- Button events since the last update (oldest first)
+     * @param[in]     event_amount -- Amount of events
+     *
+     * @return game_status_t
+     */
+    game_status_t (*update)(void* state, uint32_t dt_ms, const input_event_t* events, uint8_t event_amount);
+
+    /**
+     * @brief Draw the matrix content (the framebuffer is cleared before)
+     */
+    void (*render)(const void* state, max7219_fb_t* fb);
+
+    /**
+     * @brief Clean up (e.g., persist data); may be NULL
+     */
+    void (*exit)(void* state);
+} game_t;
+
+#endif /* GAME_H_ */
@@ -0,0 +1,155 @@
+/**
+ * @file input.c
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ * Buttons trigger an EXTI interrupt on both edges. The first edge only arms a debounce timer, which is checked from the
+ * SysTick interrupt; later bounces do not restart it. The pin is sampled INPUT_DEBOUNCE_MS after the first edge, and if
+ * it differs from the last state, a timestamped event is pushed into a lock-free single-producer (SysTick) /
+ * single-consumer (main loop) ring buffer. Injected events are pushed from SysTick as well.
+ */
+
+#include "input.h"
+
+#include "main.h"
+
+#define BUTTON_AMOUNT BUTTON_NONE
+
+typedef struct {
+    GPIO_TypeDef* port;
+    uint16_t      pin;
+} button_gpio_t;
+
+/* clang-format off */
+
+static const button_gpio_t BUTTON_GPIOS[BUTTON_AMOUNT] = {
+    [BUTTON_UP]     = { .port = BUTTON_UP_GPIO_Port,     .pin = BUTTON_UP_Pin     },
+    [BUTTON_DOWN]   = { .port = BUTTON_DOWN_GPIO_Port,   .pin = BUTTON_DOWN_Pin   },
+    [BUTTON_LEFT]   = { .port = BUTTON_LEFT_GPIO_Port,   .pin = BUTTON_LEFT_Pin   },
+    [BUTTON_RIGHT]  = { .port = BUTTON_RIGHT_GPIO_Port,  .pin = BUTTON_RIGHT_Pin  },
+    [BUTTON_CENTER] = { .port = BUTTON_CENTER_GPIO_Port, .pin = BUTTON_CENTER_Pin },
+};
+
+/* clang-format on */
+
+// Debouncing (EXTI and SysTick run on the same priority, so they never preempt each other)
+static bool     stable_state[BUTTON_AMOUNT] = { false };
+static bool     debounce_pending[BUTTON_AMOUNT] = { false };
+static uint32_t debounce_start[BUTTON_AMOUNT] = { 0 };
+
+// Ring buffer: head is only written by the producer, tail only by the consumer
+static input_event_t     queue[INPUT_QUEUE_LENGTH];
+static volatile uint8_t  queue_head     = 0;
+static volatile uint8_t  queue_tail     = 0;
+static volatile uint32_t overflow_count = 0;
+static volatile uint32_t last_event_ms  = 0;
+
+static bool queue_push(const input_event_t* event)
+{
+    uint8_t head = queue_head;
+    uint8_t next = (head + 1) & (INPUT_QUEUE_LENGTH - 1);
+
+    if (next == queue_tail) {
+        overflow_count++;
+        return false;
+    }
+
+    queue[head] = *event;
+    queue_head  = next; // Publish after the event is written
+
+    return true;
+}
+
+void input_init(void)
+{
+    for (uint8_t i = 0; i < BUTTON_AMOUNT; i++) {
+        stable_state[i]     = HAL_GPIO_ReadPin(BUTTON_GPIOS[i].port, BUTTON_GPIOS[i].pin);
+        debounce_pending[i] = false;
+    }
+
+    queue_tail    = queue_head;
+    last_event_ms = HAL_GetTick();
+}
+
+bool input_get_event(input_event_t* event)
+{
+    uint8_t tail = queue_tail;
+
+    if (tail == queue_head) {
+        return false;
+    }
+
+    *event     = queue[tail];
+    queue_tail = (tail + 1) & (INPUT_QUEUE_LENGTH - 1); // Release the slot after the event is read
+
+    return true;
+}
+
+void input_flush(void)
+{
+    queue_tail = queue_head;
+}
+
+uint32_t input_get_last_event_time(void)
+{
+    return last_event_ms;
+}
+
+uint32_t input_get_overflow_count(void)
+{
+    return overflow_count;
+}
+
+bool input_inject(const input_event_t* event)
+{
+    last_event_ms = event->timestamp_ms;
+
+    return queue_push(event);
+}
+
+void input_exti_callback(uint16_t gpio_pin)
+{
+    for (uint8_t i = 0; i < BUTTON_AMOUNT; i++) {
+        if (BUTTON_GPIOS[i].pin != gpio_pin) {
+            continue;
+        }
+
+        // Arm the debounce timer on the first edge, which defines the timestamp
+        if (!debounce_pending[i]) {
+            debounce_start[i]   = HAL_GetTick();
+            debounce_pending[i] = true;
+        }
+    }
+}
+
+void input_tick(void)
+{
+    uint32_t now = HAL_GetTick();
+
+    for (uint8_t i = 0; i < BUTTON_AMOUNT; i++) {
+        if (!debounce_pending[i] || ((now - debounce_start[i]) < INPUT_DEBOUNCE_MS)) {
+            continue;
+        }
+
+        debounce_pending[i] = false;
+
+        bool state = HAL_GPIO_ReadPin(BUTTON_GPIOS[i].port, BUTTON_GPIOS[i].pin);
+
+        if (state == stable_state[i]) {
+            continue; // Bounce or glitch
+        }
+
+        stable_state[i] = state;
+
+        input_event_t event = {
+            .timestamp_ms = debounce_start[i],
+            .button       = (button_t)i,
+            .pressed      = state,
+            .tag          = 0,
+        };
+
+        last_event_ms = event.timestamp_ms;
+        queue_push(&event);
+    }
+}
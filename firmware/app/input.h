@@ -0,0 +1,94 @@
+/**
+ * @file input.h
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ */
+
+#ifndef INPUT_H_
+#define INPUT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define INPUT_DEBOUNCE_MS  10 // The pin is sampled this long after the first edge [ms]
+#define INPUT_QUEUE_LENGTH 16 // Amount of buffered events (power of 2)
+
+typedef enum button {
+    BUTTON_UP,
+    BUTTON_DOWN,
+    BUTTON_LEFT,
+    BUTTON_RIGHT,
+    BUTTON_CENTER,
+    BUTTON_NONE,
+} button_t;
+
+/**
+ * @brief Debounced button event
+ */
+typedef struct {
+    uint32_t timestamp_ms; // HAL tick of the first edge (injected events: of the reception) [ms]
+    button_t button;
+    bool     pressed; // true: button pressed; false: button released
+    uint16_t tag;     // Host tag of an injected event (0: button)
+} input_event_t;
+
+/**
+ * @brief Initialize the input handling (samples the current button states)
+ */
+void input_init(void);
+
+/**
+ * @brief Get the oldest event from the queue (consumer side, main loop only)
+ *
+ * @param[out] event -- Event
+ *
+ * @return true  -- An event was returned
+ * @return false -- The queue is empty
+ */
+bool input_get_event(input_event_t* event);
+
+/**
+ * @brief Discard all queued events
+ */
+void input_flush(void);
+
+/**
+ * @brief HAL tick of the most recent event (press or release)
+ *
+ * @return uint32_t -- Timestamp [ms]
+ */
+uint32_t input_get_last_event_time(void);
+
+/**
+ * @brief Amount of events dropped, because the queue was full
+ *
+ * @return uint32_t -- Dropped events
+ */
+uint32_t input_get_overflow_count(void);
+
+/**
+ * @brief Queue an event which did not come from a button (e.g., remote control), to be called from the SysTick
+ *        interrupt like input_tick()
+ *
+ * @param[in] event -- Event
+ *
+ * @return true  -- Queued
+ * @return false -- The queue is full
+ */
+bool input_inject(const input_event_t* event);
+
+/**
+ * @brief Button edge handler, to be called from HAL_GPIO_EXTI_Callback()
+ *
+ * @param[in] gpio_pin -- Pin which triggered the interrupt
+ */
+void input_exti_callback(uint16_t gpio_pin);
+
+/**
+ * @brief Debounce timer, to be called from the 1 ms SysTick interrupt
+ */
+void input_tick(void);
+
+#endif /* INPUT_H_ */
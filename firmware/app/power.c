@@ -0,0 +1,148 @@
+/**
+ * @file power.c
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ * Wait loops sleep with WFI; the SysTick wakes the core every 1 ms at the latest. The time in sleep is measured with
+ * the SysTick counter, so wake-ups between two ticks are accounted correctly.
+ *
+ * Without button events for the inactivity timeout, the displays are shut down and the MCU enters stop mode. A button
+ * (EXTI) wakes it up again.
+ */
+
+#include "power.h"
+
+#include <stdbool.h>
+
+#include "app.h"
+#include "clock.h"
+#include "input.h"
+#include "main.h"
+#include "max7219.h"
+#include "remote.h"
+#include "ssd1306.h"
+#include "telemetry.h"
+
+static uint32_t      inactivity_timeout_ms = POWER_INACTIVITY_TIMEOUT_MS;
+static power_stats_t stats                 = { 0 };
+static uint32_t      sleep_cycles          = 0; // Remainder below 1 ms
+
+void power_init(void)
+{
+    __HAL_RCC_PWR_CLK_ENABLE();
+}
+
+void power_sleep(void)
+{
+    uint32_t start;
+    uint32_t end;
+    uint32_t elapsed;
+    uint32_t reload = SysTick->LOAD + 1;
+
+    // Interrupts are masked so the counter can be read before the pending interrupt is handled. WFI still wakes up.
+    __disable_irq();
+
+    if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) {
+        __enable_irq(); // SysTick already pending, not worth sleeping
+        return;
+    }
+
+    start = SysTick->VAL;
+    __WFI();
+    end = SysTick->VAL;
+
+    if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) {
+        elapsed = start + reload - end; // Counter reloaded during sleep
+    } else {
+        elapsed = start - end;
+    }
+
+    __enable_irq();
+
+    sleep_cycles += elapsed;
+    stats.sleep_count++;
+
+    while (sleep_cycles >= reload) {
+        sleep_cycles -= reload;
+        stats.sleep_ms++;
+    }
+}
+
+void power_idle(void)
+{
+    if ((inactivity_timeout_ms > 0) && ((HAL_GetTick() - input_get_last_event_time()) >= inactivity_timeout_ms)) {
+        power_stop();
+        return;
+    }
+
+    power_sleep();
+}
+
+void power_stop(void)
+{
+    telemetry_event(TELEMETRY_EVENT_STOP, 0);
+    telemetry_pause(); // The rest of the queue is sent after the wake-up
+    REMOTE_PAUSE();
+
+    // Peripherals are not clocked in stop mode, let pending transfers (and a beep, SysTick stops) finish
+    while (max7219_is_busy(&max7219) || SSD1306_IsBusy() || telemetry_is_busy() || app_beep_is_active()) {
+        power_sleep();
+    }
+
+    SSD1306_OFF();
+    max7219_send(&max7219, MAX7219_ADR_SHUTDOWN, MAX7219_REG_SHUTDOWN_MODE_SHUTDOWN);
+
+    HAL_SuspendTick();
+    HAL_PWR_EnterSTOPMode(PWR_LOWPOWERREGULATOR_ON, PWR_STOPENTRY_WFI);
+
+    // Woken up by a button, the system clock is HSI again
+    clock_restore();
+    HAL_ResumeTick();
+    telemetry_resume();
+    REMOTE_RESUME(); // clock_restore() re-initialized the UART, which ended the reception
+    telemetry_event(TELEMETRY_EVENT_WAKE_UP, 0);
+
+    stats.stop_count++;
+
+    max7219_send(&max7219, MAX7219_ADR_SHUTDOWN, MAX7219_REG_SHUTDOWN_MODE_NORMAL);
+    SSD1306_ON();
+
+    // Consume the wake-up press (it still counts as activity)
+    HAL_Delay(INPUT_DEBOUNCE_MS);
+    input_flush();
+}
+
+void power_set_inactivity_timeout(uint32_t timeout_ms)
+{
+    inactivity_timeout_ms = timeout_ms;
+}
+
+void power_get_stats(power_stats_t* stats_out)
+{
+    *stats_out = stats;
+}
+
+void power_reset_stats(void)
+{
+    stats        = (power_stats_t) { 0 };
+    sleep_cycles = 0;
+}
+
+/**
+ * @brief Overrides the weak HAL implementation, which spins at full run current
+ */
+void HAL_Delay(uint32_t Delay)
+{
+    uint32_t tickstart = HAL_GetTick();
+    uint32_t wait      = Delay;
+
+    // Add a freq to guarantee minimum wait
+    if (wait < HAL_MAX_DELAY) {
+        wait += (uint32_t)(uwTickFreq);
+    }
+
+    while ((HAL_GetTick() - tickstart) < wait) {
+        power_sleep();
+    }
+}
@@ -0,0 +1,65 @@
+/**
+ * @file power.h
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ */
+
+#ifndef POWER_H_
+#define POWER_H_
+
+#include <stdint.h>
+
+#ifndef POWER_INACTIVITY_TIMEOUT_MS
+#define POWER_INACTIVITY_TIMEOUT_MS (2 * 60 * 1000) // Time without button event until stop mode is entered [ms]
+#endif
+
+typedef struct {
+    uint32_t sleep_ms;    // Time spent in sleep mode (WFI) [ms]
+    uint32_t sleep_count; // Amount of WFI sleeps
+    uint32_t stop_count;  // Amount of stop mode entries (time in stop mode is not measured, SysTick is halted)
+} power_stats_t;
+
+/**
+ * @brief Initialize the power management
+ */
+void power_init(void);
+
+/**
+ * @brief Sleep (WFI) until the next interrupt, at the latest until the next SysTick
+ */
+void power_sleep(void);
+
+/**
+ * @brief Idle step of a wait loop: sleeps, or enters stop mode once the inactivity timeout is elapsed
+ */
+void power_idle(void);
+
+/**
+ * @brief Shut down the displays and enter stop mode until a button is pressed
+ *
+ * The button press which wakes up the device is consumed.
+ */
+void power_stop(void);
+
+/**
+ * @brief Set the inactivity timeout
+ *
+ * @param[in] timeout_ms -- Timeout [ms], 0 disables stop mode
+ */
+void power_set_inactivity_timeout(uint32_t timeout_ms);
+
+/**
+ * @brief Get the power statistics
+ *
+ * @param[out] stats -- Statistics
+ */
+void power_get_stats(power_stats_t* stats);
+
+/**
+ * @brief Reset the power statistics
+ */
+void power_reset_stats(void);
+
+#endif /* POWER_H_ */
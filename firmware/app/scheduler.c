@@ -0,0 +1,92 @@
+/**
+ * @file scheduler.c
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ * Fixed timestep loop driven by the 1 ms SysTick (HAL_GetTick()). Late ticks are caught up by running the update hook
+ * several times before rendering once. If the loop falls too far behind, the missing ticks are dropped and counted as
+ * overrun, so a long blocking call does not make the game "fast forward".
+ */
+
+#include "scheduler.h"
+
+#include <stddef.h>
+
+#include "main.h"
+#include "power.h"
+#include "profile.h"
+
+static bool tick_elapsed(uint32_t now_ms, uint32_t tick_ms)
+{
+    return (int32_t)(now_ms - tick_ms) >= 0; // Wrap-around safe
+}
+
+void scheduler_init(scheduler_t* scheduler, uint32_t period_ms, scheduler_hook_t update, scheduler_hook_t render,
+                    void* context)
+{
+    scheduler->period_ms    = (period_ms > 0) ? period_ms : 1;
+    scheduler->next_tick_ms = 0;
+    scheduler->update       = update;
+    scheduler->render       = render;
+    scheduler->context      = context;
+    scheduler->running      = false;
+    scheduler->stats        = (scheduler_stats_t) { 0 };
+}
+
+void scheduler_run(scheduler_t* scheduler)
+{
+    scheduler->running      = true;
+    scheduler->next_tick_ms = HAL_GetTick() + scheduler->period_ms;
+
+    while (scheduler->running) {
+        uint32_t now = HAL_GetTick();
+
+        if (!tick_elapsed(now, scheduler->next_tick_ms)) {
+            power_idle(); // Woken up at the latest by the next SysTick, stop mode after inactivity
+            continue;
+        }
+
+        PROFILE_FRAME_BEGIN();
+
+        uint8_t updates = 0;
+
+        while (scheduler->running && tick_elapsed(now, scheduler->next_tick_ms) &&
+               (updates < SCHEDULER_MAX_CATCH_UP)) {
+            if (updates > 0) {
+                scheduler->stats.late_updates++;
+            }
+
+            scheduler->update(scheduler->context);
+            scheduler->stats.updates++;
+            scheduler->next_tick_ms += scheduler->period_ms;
+            updates++;
+        }
+
+        if (scheduler->running && tick_elapsed(now, scheduler->next_tick_ms)) {
+            // Still behind, resynchronize instead of running an unbounded burst of updates
+            uint32_t missed = (now - scheduler->next_tick_ms) / scheduler->period_ms + 1;
+
+            scheduler->stats.overruns++;
+            scheduler->stats.dropped_ticks += missed;
+            scheduler->next_tick_ms += missed * scheduler->period_ms;
+        }
+
+        if (scheduler->running && (scheduler->render != NULL)) {
+            scheduler->render(scheduler->context);
+            scheduler->stats.renders++;
+        }
+
+        PROFILE_FRAME_END(scheduler->period_ms);
+    }
+}
+
+void scheduler_stop(scheduler_t* scheduler)
+{
+    scheduler->running = false;
+}
+
+const scheduler_stats_t* scheduler_get_stats(const scheduler_t* scheduler)
+{
+    return &scheduler->stats;
+}
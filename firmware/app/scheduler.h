@@ -0,0 +1,74 @@
+/**
+ * @file scheduler.h
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ */
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SCHEDULER_MAX_CATCH_UP 4 // Max. amount of late updates executed back to back before ticks are dropped
+
+typedef void (*scheduler_hook_t)(void* context);
+
+typedef struct {
+    uint32_t updates;       // Executed update hooks
+    uint32_t renders;       // Executed render hooks
+    uint32_t late_updates;  // Updates executed after their tick (catch-up)
+    uint32_t overruns;      // Amount of times the loop fell behind by more than SCHEDULER_MAX_CATCH_UP ticks
+    uint32_t dropped_ticks; // Ticks skipped because of overruns
+} scheduler_stats_t;
+
+typedef struct {
+    uint32_t          period_ms;
+    uint32_t          next_tick_ms;
+    scheduler_hook_t  update;
+    scheduler_hook_t  render;
+    void*             context;
+    volatile bool     running;
+    scheduler_stats_t stats;
+} scheduler_t;
+
+/**
+ * @brief Initialize a fixed timestep scheduler
+ *
+ * @param[out] scheduler -- Scheduler
+ * @param[in]  period_ms -- Period between two update hooks [ms]
+ * @param[in]  update    -- Hook called once per tick (game logic)
+ * @param[in]  render    -- Hook called after the updates of a tick (output), may be NULL
+ * @param[in]  context   -- Pointer passed to the hooks
+ */
+void scheduler_init(scheduler_t* scheduler, uint32_t period_ms, scheduler_hook_t update, scheduler_hook_t render,
+                    void* context);
+
+/**
+ * @brief Run the scheduler until scheduler_stop() is called (typically from a hook)
+ *
+ * The first update is executed one period after the call. The CPU sleeps (WFI) between ticks.
+ *
+ * @param[in,out] scheduler -- Scheduler
+ */
+void scheduler_run(scheduler_t* scheduler);
+
+/**
+ * @brief Stop the scheduler; scheduler_run() returns after the current hook
+ *
+ * @param[in,out] scheduler -- Scheduler
+ */
+void scheduler_stop(scheduler_t* scheduler);
+
+/**
+ * @brief Get the scheduler statistics
+ *
+ * @param[in] scheduler -- Scheduler
+ *
+ * @return const scheduler_stats_t* -- Statistics
+ */
+const scheduler_stats_t* scheduler_get_stats(const scheduler_t* scheduler);
+
+#endif /* SCHEDULER_H_ */
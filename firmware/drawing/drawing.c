@@ -8,7 +8,6 @@
 
 #include "drawing.h"
 
-#include <stdio.h>
 #include <stdbool.h>
 
 #include "app.h"
@@ -20,6 +19,26 @@ typedef struct {
     uint8_t col;
 } cursor_t;
 
+typedef struct {
+    max7219_fb_t canvas;
+    cursor_t     cursor;
+} drawing_state_t;
+
+GAME_STATE_ASSERT(drawing_state_t);
+
+static void          drawing_init(void* context);
+static game_status_t drawing_update(void* context, uint32_t dt_ms, const input_event_t* events, uint8_t event_amount);
+static void          drawing_render(const void* context, max7219_fb_t* fb);
+
+const game_t drawing_game = {
+    .name       = "Drawing",
+    .state_size = sizeof(drawing_state_t),
+    .init       = drawing_init,
+    .update     = drawing_update,
+    .render     = drawing_render,
+    .exit       = NULL,
+};
+
 static void lcd_start(void)
 {
     app_lcd_print_title();
@@ -31,59 +50,72 @@ static void lcd_start(void)
     SSD1306_UpdateScreen();
 }
 
-void drawing(void)
+static void drawing_init(void* context)
 {
-    cursor_t cursor = { .row = 0, .col = 0 };
+    drawing_state_t* state = context; // Zeroed by the shell: cursor top left
 
-    app_matrix_clean(matrix);
-    max7219_set_matrix(&max7219, matrix);
+    max7219_fb_set_pixel(&state->canvas, state->cursor.col, state->cursor.row); // The start pixel is drawn at once
 
     lcd_start();
+}
+
+static game_status_t drawing_update(void* context, uint32_t dt_ms, const input_event_t* events, uint8_t event_amount)
+{
+    drawing_state_t* state = context;
 
-    while (1) {
-        // read user button
-        button_t button = app_get_user_input();
+    (void)dt_ms;
+
+    for (uint8_t i = 0; i < event_amount; i++) {
+        if (!events[i].pressed) {
+            continue;
+        }
 
         // update cursor
-        switch (button) {
+        switch (events[i].button) {
         case BUTTON_RIGHT:
-            if (cursor.col < MAX7219_COLUMN_AMOUNT - 1) {
-                cursor.col++;
+            if (state->cursor.col < MAX7219_COLUMN_AMOUNT - 1) {
+                state->cursor.col++;
             }
 
             break;
 
         case BUTTON_LEFT:
-            if (cursor.col > 0) {
-                cursor.col--;
+            if (state->cursor.col > 0) {
+                state->cursor.col--;
             }
 
             break;
 
         case BUTTON_UP:
-            if (cursor.row > 0) {
-                cursor.row--;
+            if (state->cursor.row > 0) {
+                state->cursor.row--;
             }
 
             break;
 
         case BUTTON_DOWN:
-            if (cursor.row < MAX7219_ROW_AMOUNT - 1) {
-                cursor.row++;
+            if (state->cursor.row < MAX7219_ROW_AMOUNT - 1) {
+                state->cursor.row++;
             }
 
             break;
 
         case BUTTON_CENTER:
-            return; // end
+            return GAME_EXIT; // end
 
         default:
             break;
         }
 
-        matrix[cursor.col][cursor.row] = true;
-
-        // update matrix
-        max7219_set_matrix(&max7219, matrix);
+        max7219_fb_set_pixel(&state->canvas, state->cursor.col, state->cursor.row);
     }
+
+    return GAME_CONTINUE;
+}
+
+static void drawing_render(const void* context, max7219_fb_t* fb)
+{
+    const drawing_state_t* state = context;
+
+    *fb = state->canvas;
 }
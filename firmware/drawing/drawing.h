@@ -9,6 +9,8 @@
 #ifndef DRAWING_H_
 #define DRAWING_H_
 
-void drawing(void);
+#include "game.h"
+
+extern const game_t drawing_game;
 
 #endif /* DRAWING_H_ */
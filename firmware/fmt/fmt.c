@@ -0,0 +1,168 @@
+/**
+ * @file fmt.c
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ */
+
+#include "fmt.h"
+
+#define FMT_MAX_DECIMALS 9
+
+/* clang-format off */
+
+static const uint32_t POWERS_OF_TEN[FMT_UINT32_DIGITS] = {
+    1000000000, 100000000, 10000000, 1000000, 100000,
+    10000,      1000,      100,      10,      1,
+};
+
+/* clang-format on */
+
+/**
+ * @brief Convert to decimal digits (most significant first, no leading zeros except for 0)
+ *
+ * @param[in]  value  -- Value
+ * @param[out] digits -- Digits (FMT_UINT32_DIGITS characters)
+ *
+ * @return uint8_t -- Amount of digits
+ */
+static uint8_t to_digits(uint32_t value, char* digits)
+{
+    uint8_t amount = 0;
+
+    for (uint8_t i = 0; i < FMT_UINT32_DIGITS; i++) {
+        char digit = '0';
+
+        // At most 9 subtractions per digit, cheaper than a software division
+        while (value >= POWERS_OF_TEN[i]) {
+            value -= POWERS_OF_TEN[i];
+            ++digit;
+        }
+
+        if ((amount > 0) || (digit != '0') || (i == (FMT_UINT32_DIGITS - 1))) {
+            digits[amount++] = digit;
+        }
+    }
+
+    return amount;
+}
+
+static void append_padding(fmt_t* fmt, uint8_t used, uint8_t width, char pad)
+{
+    while (used < width) {
+        fmt_char(fmt, pad);
+        ++used;
+    }
+}
+
+static void append_number(fmt_t* fmt, uint32_t magnitude, bool negative, uint8_t width, char pad)
+{
+    char    digits[FMT_UINT32_DIGITS];
+    uint8_t amount = to_digits(magnitude, digits);
+    uint8_t used   = amount + (negative ? 1 : 0);
+
+    if (negative && (pad == '0')) {
+        fmt_char(fmt, '-'); // "-007"
+        negative = false;
+    }
+
+    append_padding(fmt, used, width, pad);
+
+    if (negative) {
+        fmt_char(fmt, '-'); // "  -7"
+    }
+
+    for (uint8_t i = 0; i < amount; i++) {
+        fmt_char(fmt, digits[i]);
+    }
+}
+
+static uint32_t magnitude(int32_t value)
+{
+    // Unsigned negation, also correct for INT32_MIN
+    return (value < 0) ? (0U - (uint32_t)value) : (uint32_t)value;
+}
+
+void fmt_init(fmt_t* fmt, char* buffer, uint16_t size)
+{
+    fmt->buffer    = buffer;
+    fmt->size      = size;
+    fmt->length    = 0;
+    fmt->truncated = false;
+
+    if (size > 0) {
+        buffer[0] = '\0';
+    }
+}
+
+void fmt_char(fmt_t* fmt, char c)
+{
+    if ((fmt->length + 1) >= fmt->size) {
+        fmt->truncated = true;
+        return;
+    }
+
+    fmt->buffer[fmt->length++] = c;
+    fmt->buffer[fmt->length]   = '\0';
+}
+
+void fmt_str(fmt_t* fmt, const char* string)
+{
+    while (*string != '\0') {
+        fmt_char(fmt, *string++);
+    }
+}
+
+void fmt_uint(fmt_t* fmt, uint32_t value, uint8_t width, char pad)
+{
+    append_number(fmt, value, false, width, pad);
+}
+
+void fmt_int(fmt_t* fmt, int32_t value, uint8_t width, char pad)
+{
+    append_number(fmt, magnitude(value), value < 0, width, pad);
+}
+
+void fmt_fixed(fmt_t* fmt, int32_t value, uint8_t decimals)
+{
+    char    digits[FMT_UINT32_DIGITS];
+    uint8_t amount = to_digits(magnitude(value), digits);
+
+    if (decimals > FMT_MAX_DECIMALS) {
+        decimals = FMT_MAX_DECIMALS;
+    }
+
+    if (value < 0) {
+        fmt_char(fmt, '-');
+    }
+
+    // Integer part ("0" if all digits are decimals)
+    if (amount <= decimals) {
+        fmt_char(fmt, '0');
+    } else {
+        for (uint8_t i = 0; i < (amount - decimals); i++) {
+            fmt_char(fmt, digits[i]);
+        }
+    }
+
+    if (decimals == 0) {
+        return;
+    }
+
+    fmt_char(fmt, '.');
+
+    // Fraction, leading zeros if the value has less digits than decimals
+    for (uint8_t i = amount; i < decimals; i++) {
+        fmt_char(fmt, '0');
+    }
+
+    for (uint8_t i = (amount > decimals) ? (amount - decimals) : 0; i < amount; i++) {
+        fmt_char(fmt, digits[i]);
+    }
+}
+
+const char* fmt_get(const fmt_t* fmt)
+{
+    return fmt->buffer;
+}
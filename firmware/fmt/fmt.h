@@ -0,0 +1,96 @@
+/**
+ * @file fmt.h
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ */
+
+#ifndef FMT_H_
+#define FMT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Minimal string formatter (replaces sprintf()). Text is appended to a caller buffer which is always terminated; output
+ * which does not fit is cut off and flagged. Decimal conversion uses subtraction of powers of ten, the Cortex-M0 has no
+ * divide instruction.
+ */
+
+#define FMT_UINT32_DIGITS 10 // Max. decimal digits of a uint32_t
+
+/**
+ * @brief Formatter state
+ */
+typedef struct {
+    char*    buffer;
+    uint16_t size;      // Buffer size incl. terminator [bytes]
+    uint16_t length;    // Characters written (without terminator)
+    bool     truncated; // Output did not fit
+} fmt_t;
+
+/**
+ * @brief Initialize the formatter with an empty string
+ *
+ * @param[out] fmt    -- Formatter
+ * @param[in]  buffer -- Output buffer
+ * @param[in]  size   -- Size of the output buffer (> 0) [bytes]
+ */
+void fmt_init(fmt_t* fmt, char* buffer, uint16_t size);
+
+/**
+ * @brief Append a character
+ *
+ * @param[in,out] fmt -- Formatter
+ * @param[in]     c   -- Character
+ */
+void fmt_char(fmt_t* fmt, char c);
+
+/**
+ * @brief Append a string
+ *
+ * @param[in,out] fmt    -- Formatter
+ * @param[in]     string -- Null-terminated string
+ */
+void fmt_str(fmt_t* fmt, const char* string);
+
+/**
+ * @brief Append an unsigned decimal number
+ *
+ * @param[in,out] fmt   -- Formatter
+ * @param[in]     value -- Value
+ * @param[in]     width -- Min. width, shorter numbers are padded on the left (0: no padding)
+ * @param[in]     pad   -- Padding character (e.g., ' ' or '0')
+ */
+void fmt_uint(fmt_t* fmt, uint32_t value, uint8_t width, char pad);
+
+/**
+ * @brief Append a signed decimal number
+ *
+ * @param[in,out] fmt   -- Formatter
+ * @param[in]     value -- Value
+ * @param[in]     width -- Min. width incl. sign (0: no padding)
+ * @param[in]     pad   -- Padding character, with '0' the sign is placed before the zeros
+ */
+void fmt_int(fmt_t* fmt, int32_t value, uint8_t width, char pad);
+
+/**
+ * @brief Append a fixed-point number (e.g., value 1234 with 2 decimals: "12.34")
+ *
+ * @param[in,out] fmt      -- Formatter
+ * @param[in]     value    -- Value scaled by 10^decimals
+ * @param[in]     decimals -- Digits after the decimal point (0..9)
+ */
+void fmt_fixed(fmt_t* fmt, int32_t value, uint8_t decimals);
+
+/**
+ * @brief Get the formatted string
+ *
+ * @param[in] fmt -- Formatter
+ *
+ * @return const char* -- Null-terminated string
+ */
+const char* fmt_get(const fmt_t* fmt);
+
+#endif /* FMT_H_ */
@@ -21,6 +21,8 @@
    ----------------------------------------------------------------------
  */
 #include "ssd1306.h"
+#include "mirror.h"
+#include "profile.h"
 
 extern I2C_HandleTypeDef hi2c1;
 #define SSD1306_I2C &hi2c1
@@ -30,22 +32,83 @@ extern I2C_HandleTypeDef hi2c1;
 #define SSD1306_WRITECOMMAND(command)      ssd1306_I2C_Write(SSD1306_I2C_ADDR, 0x00, (command))
 /* Write data */
 #define SSD1306_WRITEDATA(data)            ssd1306_I2C_Write(SSD1306_I2C_ADDR, 0x40, (data))
+/* I2C timeout of a multi byte write [ms], a full frame takes ~23 ms at 400 kHz */
+#define SSD1306_I2C_WRITE_TIMEOUT(count)   (10 + (count) / 16)
 /* Absolute value */
 #define ABS(x)   ((x) > 0 ? (x) : -(x))
 
-/* SSD1306 data buffer */
+/* SSD1306 data buffer (back buffer, all drawing goes here) */
 static uint8_t SSD1306_Buffer[SSD1306_WIDTH * SSD1306_HEIGHT / 8];
 
+/* Frozen copy of the dirty window, sent by DMA while the back buffer is drawn into */
+static uint8_t SSD1306_FrontBuffer[SSD1306_WIDTH * SSD1306_HEIGHT / 8];
+
 /* Private SSD1306 structure */
 typedef struct {
 	uint16_t CurrentX;
 	uint16_t CurrentY;
 	uint8_t Inverted;
 	uint8_t Initialized;
+	uint8_t Dirty;          /* Buffer has changes which are not sent to the LCD yet */
+	uint8_t DirtyColStart;  /* Dirty window, first column */
+	uint8_t DirtyColEnd;    /* Dirty window, last column */
+	uint8_t DirtyPageStart; /* Dirty window, first page */
+	uint8_t DirtyPageEnd;   /* Dirty window, last page */
 } SSD1306_t;
 
+/* Private asynchronous transfer structure */
+typedef struct {
+	volatile uint8_t Busy;        /* DMA transfer in progress */
+	volatile uint8_t SwapPending; /* Another update was requested while busy */
+	uint8_t Window[6];            /* Column/page window commands */
+	uint8_t ColStart;             /* Window being transferred */
+	uint8_t Width;
+	uint8_t Page;                 /* Next page to be transferred */
+	uint8_t PageEnd;
+} SSD1306_Async_t;
+
 /* Private variable */
 static SSD1306_t SSD1306;
+static SSD1306_Async_t SSD1306_Async;
+
+/* Grow the dirty window so it contains the given columns and pages */
+static void SSD1306_MarkDirty(uint8_t col_start, uint8_t col_end, uint8_t page_start, uint8_t page_end) {
+	/* The asynchronous update consumes the window from interrupt context */
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	
+	MIRROR_OLED_DIRTY(col_start, col_end, page_start, page_end);
+	
+	if (!SSD1306.Dirty) {
+		SSD1306.Dirty = 1;
+		SSD1306.DirtyColStart = col_start;
+		SSD1306.DirtyColEnd = col_end;
+		SSD1306.DirtyPageStart = page_start;
+		SSD1306.DirtyPageEnd = page_end;
+		__set_PRIMASK(primask);
+		return;
+	}
+	
+	if (col_start < SSD1306.DirtyColStart) {
+		SSD1306.DirtyColStart = col_start;
+	}
+	if (col_end > SSD1306.DirtyColEnd) {
+		SSD1306.DirtyColEnd = col_end;
+	}
+	if (page_start < SSD1306.DirtyPageStart) {
+		SSD1306.DirtyPageStart = page_start;
+	}
+	if (page_end > SSD1306.DirtyPageEnd) {
+		SSD1306.DirtyPageEnd = page_end;
+	}
+	
+	__set_PRIMASK(primask);
+}
+
+/* Mark the whole buffer as dirty */
+static void SSD1306_MarkAllDirty(void) {
+	SSD1306_MarkDirty(0, SSD1306_WIDTH - 1, 0, (SSD1306_HEIGHT / 8) - 1);
+}
 
 
 uint8_t SSD1306_Init(void) {
@@ -67,7 +130,7 @@ uint8_t SSD1306_Init(void) {
 	/* Init LCD */
 	SSD1306_WRITECOMMAND(0xAE); //display off
 	SSD1306_WRITECOMMAND(0x20); //Set Memory Addressing Mode   
-	SSD1306_WRITECOMMAND(0x10); //00,Horizontal Addressing Mode;01,Vertical Addressing Mode;10,Page Addressing Mode (RESET);11,Invalid
+	SSD1306_WRITECOMMAND(0x00); //00,Horizontal Addressing Mode;01,Vertical Addressing Mode;10,Page Addressing Mode (RESET);11,Invalid
 	SSD1306_WRITECOMMAND(0xB0); //Set Page Start Address for Page Addressing Mode,0-7
 	SSD1306_WRITECOMMAND(0xC8); //Set COM Output Scan Direction
 	SSD1306_WRITECOMMAND(0x00); //---set low column address
@@ -135,16 +198,160 @@ uint8_t SSD1306_Init(void) {
 }
 
 void SSD1306_UpdateScreen(void) {
-	uint8_t m;
+	uint8_t page;
+	uint16_t width;
+	
+	/* Wait for a running asynchronous update (woken up by the DMA interrupts) */
+	while (SSD1306_Async.Busy) {
+		__WFI();
+	}
+	
+	/* Nothing changed since the last update */
+	if (!SSD1306.Dirty) {
+		return;
+	}
+	
+	PROFILE_BEGIN(PROFILE_SCOPE_OLED_UPDATE);
+	
+	/* Horizontal addressing mode: set the dirty window once, the address wraps from page to page by itself */
+	uint8_t window[] = {
+		0x21, SSD1306.DirtyColStart, SSD1306.DirtyColEnd,   /* Column start/end address */
+		0x22, SSD1306.DirtyPageStart, SSD1306.DirtyPageEnd, /* Page start/end address */
+	};
+	
+	ssd1306_I2C_WriteMulti(SSD1306_I2C_ADDR, 0x00, window, sizeof(window));
+	
+	width = SSD1306.DirtyColEnd - SSD1306.DirtyColStart + 1;
+	
+	if (width == SSD1306_WIDTH) {
+		/* Full width pages are contiguous in the buffer, write them in one burst */
+		ssd1306_I2C_WriteMulti(SSD1306_I2C_ADDR, 0x40, &SSD1306_Buffer[SSD1306_WIDTH * SSD1306.DirtyPageStart],
+		                       width * (SSD1306.DirtyPageEnd - SSD1306.DirtyPageStart + 1));
+	} else {
+		/* Write the dirty part of each page */
+		for (page = SSD1306.DirtyPageStart; page <= SSD1306.DirtyPageEnd; page++) {
+			ssd1306_I2C_WriteMulti(SSD1306_I2C_ADDR, 0x40, &SSD1306_Buffer[SSD1306_WIDTH * page + SSD1306.DirtyColStart], width);
+		}
+	}
+	
+	SSD1306.Dirty = 0;
+	
+	PROFILE_END(PROFILE_SCOPE_OLED_UPDATE);
+}
+
+/* Freeze the dirty window into the front buffer and start sending it (SSD1306_Async.Busy must already be set) */
+static void SSD1306_StartAsyncTransfer(void) {
+	uint8_t page;
+	
+	if (!SSD1306.Dirty) {
+		SSD1306_Async.Busy = 0;
+		return;
+	}
+	
+	SSD1306_Async.ColStart = SSD1306.DirtyColStart;
+	SSD1306_Async.Width = SSD1306.DirtyColEnd - SSD1306.DirtyColStart + 1;
+	SSD1306_Async.Page = SSD1306.DirtyPageStart;
+	SSD1306_Async.PageEnd = SSD1306.DirtyPageEnd;
+	
+	for (page = SSD1306.DirtyPageStart; page <= SSD1306.DirtyPageEnd; page++) {
+		memcpy(&SSD1306_FrontBuffer[SSD1306_WIDTH * page + SSD1306_Async.ColStart],
+		       &SSD1306_Buffer[SSD1306_WIDTH * page + SSD1306_Async.ColStart], SSD1306_Async.Width);
+	}
+	
+	SSD1306_Async.Window[0] = 0x21; /* Column start/end address */
+	SSD1306_Async.Window[1] = SSD1306.DirtyColStart;
+	SSD1306_Async.Window[2] = SSD1306.DirtyColEnd;
+	SSD1306_Async.Window[3] = 0x22; /* Page start/end address */
+	SSD1306_Async.Window[4] = SSD1306.DirtyPageStart;
+	SSD1306_Async.Window[5] = SSD1306.DirtyPageEnd;
+	
+	SSD1306.Dirty = 0;
+	
+	PROFILE_BUS(PROFILE_BUS_I2C1, 1 + sizeof(SSD1306_Async.Window));
 	
-	for (m = 0; m < 8; m++) {
-		SSD1306_WRITECOMMAND(0xB0 + m);
-		SSD1306_WRITECOMMAND(0x00);
-		SSD1306_WRITECOMMAND(0x10);
+	if (HAL_I2C_Mem_Write_DMA(SSD1306_I2C, SSD1306_I2C_ADDR, 0x00, I2C_MEMADD_SIZE_8BIT, SSD1306_Async.Window, sizeof(SSD1306_Async.Window)) != HAL_OK) {
+		SSD1306_MarkAllDirty();
+		SSD1306_Async.Busy = 0;
+	}
+}
+
+uint8_t SSD1306_UpdateScreenAsync(void) {
+	uint8_t busy;
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	
+	busy = SSD1306_Async.Busy;
+	if (busy) {
+		/* Swapped from main context once the running transfer is done, see SSD1306_UpdatePending() */
+		SSD1306_Async.SwapPending = 1;
+	} else {
+		SSD1306_Async.Busy = 1;
+		SSD1306_Async.SwapPending = 0;
+	}
+	
+	__set_PRIMASK(primask);
+	
+	if (busy) {
+		return 0;
+	}
+	
+	SSD1306_StartAsyncTransfer();
+	
+	return 1;
+}
+
+void SSD1306_UpdatePending(void) {
+	if (SSD1306_Async.SwapPending && !SSD1306_Async.Busy) {
+		SSD1306_UpdateScreenAsync();
+	}
+}
+
+uint8_t SSD1306_IsBusy(void) {
+	return SSD1306_Async.Busy;
+}
+
+const uint8_t* SSD1306_GetBuffer(void) {
+	return SSD1306_Buffer;
+}
+
+void SSD1306_I2C_TxCpltCallback(void) {
+	uint8_t* data;
+	uint16_t count;
+	
+	if (!SSD1306_Async.Busy) {
+		return;
+	}
+	
+	if (SSD1306_Async.Page <= SSD1306_Async.PageEnd) {
+		data = &SSD1306_FrontBuffer[SSD1306_WIDTH * SSD1306_Async.Page + SSD1306_Async.ColStart];
 		
-		/* Write multi data */
-		ssd1306_I2C_WriteMulti(SSD1306_I2C_ADDR, 0x40, &SSD1306_Buffer[SSD1306_WIDTH * m], SSD1306_WIDTH);
+		if (SSD1306_Async.Width == SSD1306_WIDTH) {
+			/* Full width pages are contiguous, send them in one burst */
+			count = SSD1306_WIDTH * (SSD1306_Async.PageEnd - SSD1306_Async.Page + 1);
+			SSD1306_Async.Page = SSD1306_Async.PageEnd + 1;
+		} else {
+			count = SSD1306_Async.Width;
+			SSD1306_Async.Page++;
+		}
+		
+		PROFILE_BUS(PROFILE_BUS_I2C1, 1 + count);
+		
+		if (HAL_I2C_Mem_Write_DMA(SSD1306_I2C, SSD1306_I2C_ADDR, 0x40, I2C_MEMADD_SIZE_8BIT, data, count) != HAL_OK) {
+			SSD1306_I2C_ErrorCallback();
+		}
+		
+		return;
 	}
+	
+	/* Frame done. A pending swap is left to the main context, the back buffer may be half drawn right now. */
+	SSD1306_Async.Busy = 0;
+}
+
+void SSD1306_I2C_ErrorCallback(void) {
+	/* LCD content unknown, send everything with the next update */
+	SSD1306_MarkAllDirty();
+	SSD1306_Async.SwapPending = 0;
+	SSD1306_Async.Busy = 0;
 }
 
 void SSD1306_ToggleInvert(void) {
@@ -157,11 +364,15 @@ void SSD1306_ToggleInvert(void) {
 	for (i = 0; i < sizeof(SSD1306_Buffer); i++) {
 		SSD1306_Buffer[i] = ~SSD1306_Buffer[i];
 	}
+	
+	SSD1306_MarkAllDirty();
 }
 
 void SSD1306_Fill(SSD1306_COLOR_t color) {
 	/* Set memory */
 	memset(SSD1306_Buffer, (color == SSD1306_COLOR_BLACK) ? 0x00 : 0xFF, sizeof(SSD1306_Buffer));
+	
+	SSD1306_MarkAllDirty();
 }
 
 void SSD1306_DrawPixel(uint16_t x, uint16_t y, SSD1306_COLOR_t color) {
@@ -179,10 +390,19 @@ void SSD1306_DrawPixel(uint16_t x, uint16_t y, SSD1306_COLOR_t color) {
 	}
 	
 	/* Set color */
+	uint8_t* byte = &SSD1306_Buffer[x + (y / 8) * SSD1306_WIDTH];
+	uint8_t value;
+	
 	if (color == SSD1306_COLOR_WHITE) {
-		SSD1306_Buffer[x + (y / 8) * SSD1306_WIDTH] |= 1 << (y % 8);
+		value = *byte | (1 << (y % 8));
 	} else {
-		SSD1306_Buffer[x + (y / 8) * SSD1306_WIDTH] &= ~(1 << (y % 8));
+		value = *byte & ~(1 << (y % 8));
+	}
+	
+	/* Only pixels which really change need to be sent to the LCD */
+	if (value != *byte) {
+		*byte = value;
+		SSD1306_MarkDirty(x, x, y / 8, y / 8);
 	}
 }
 
@@ -643,18 +863,21 @@ void ssd1306_I2C_Init() {
 }
 
 void ssd1306_I2C_WriteMulti(uint8_t address, uint8_t reg, uint8_t* data, uint16_t count) {
-uint8_t dt[256];
-dt[0] = reg;
-uint8_t i;
-for(i = 0; i < count; i++)
-dt[i+1] = data[i];
-HAL_I2C_Master_Transmit(SSD1306_I2C, address, dt, count+1, 10);
+	/* The control byte is sent as 8-bit "register address", the data straight from the caller's buffer */
+	PROFILE_BUS(PROFILE_BUS_I2C1, 1 + count);
+	HAL_I2C_Mem_Write(SSD1306_I2C, address, reg, I2C_MEMADD_SIZE_8BIT, data, count, SSD1306_I2C_WRITE_TIMEOUT(count));
 }
 
 
 void ssd1306_I2C_Write(uint8_t address, uint8_t reg, uint8_t data) {
+	/* Wait for a running asynchronous update (woken up by the DMA interrupts) */
+	while (SSD1306_Async.Busy) {
+		__WFI();
+	}
+	
 	uint8_t dt[2];
 	dt[0] = reg;
 	dt[1] = data;
+	PROFILE_BUS(PROFILE_BUS_I2C1, sizeof(dt));
 	HAL_I2C_Master_Transmit(SSD1306_I2C, address, dt, 2, 10);
 }
@@ -83,12 +83,75 @@ uint8_t SSD1306_Init(void);
 
 /** 
  * @brief  Updates buffer from internal RAM to LCD
- * @note   This function must be called each time you do some changes to LCD, to update buffer from RAM to LCD
+ * @note   This function must be called each time you do some changes to LCD, to update buffer from RAM to LCD.
+ *         Only the window of pages and columns changed since the last update is sent.
  * @param  None
  * @retval None
  */
 void SSD1306_UpdateScreen(void);
 
+/**
+ * @brief  Updates the LCD from internal RAM without blocking (I2C DMA)
+ * @note   The dirty window is copied into a front buffer which is sent in the background, so drawing may continue
+ *         right away. If a transfer is still running, the update is deferred until it is done and started by the
+ *         next call of this function or of SSD1306_UpdatePending() ("swap when idle"), never from interrupt context.
+ * @param  None
+ * @retval Update status:
+ *           - 0: Transfer still running, update is pending
+ *           - 1: Update started (or nothing to update)
+ */
+uint8_t SSD1306_UpdateScreenAsync(void);
+
+/**
+ * @brief  Starts an update deferred by SSD1306_UpdateScreenAsync() once the running transfer is done
+ * @note   Call from the main loop while waiting, at a point where the buffer holds a complete frame
+ * @param  None
+ * @retval None
+ */
+void SSD1306_UpdatePending(void);
+
+/**
+ * @brief  Checks if an asynchronous update is in progress
+ * @param  None
+ * @retval 1 while the LCD is being updated, 0 otherwise
+ */
+uint8_t SSD1306_IsBusy(void);
+
+/**
+ * @brief  Gets the buffer the drawing functions write to (one byte per column and page, page by page)
+ * @param  None
+ * @retval Buffer of SSD1306_WIDTH * SSD1306_HEIGHT / 8 bytes
+ */
+const uint8_t* SSD1306_GetBuffer(void);
+
+/**
+ * @brief  Turns the LCD and its charge pump on
+ * @param  None
+ * @retval None
+ */
+void SSD1306_ON(void);
+
+/**
+ * @brief  Turns the LCD and its charge pump off (display RAM is retained)
+ * @param  None
+ * @retval None
+ */
+void SSD1306_OFF(void);
+
+/**
+ * @brief  I2C memory write complete handler, to be called from HAL_I2C_MemTxCpltCallback()
+ * @param  None
+ * @retval None
+ */
+void SSD1306_I2C_TxCpltCallback(void);
+
+/**
+ * @brief  I2C error handler, to be called from HAL_I2C_ErrorCallback()
+ * @param  None
+ * @retval None
+ */
+void SSD1306_I2C_ErrorCallback(void);
+
 /**
  * @brief  Toggles pixels invertion inside internal RAM
  * @note   @ref SSD1306_UpdateScreen() must be called after that in order to see updated LCD screen
@@ -8,6 +8,8 @@
 
 #include "max7219.h"
 
+#include "profile.h"
+
 max7219_error_t max7219_init(max7219_t* max7219, const SPI_HandleTypeDef* spi, const GPIO_TypeDef* cs_port, uint16_t cs_pin)
 {
     max7219_error_t error_code = MAX7219_OK;
@@ -24,9 +26,14 @@ max7219_error_t max7219_init(max7219_t* max7219, const SPI_HandleTypeDef* spi, c
         return MAX7219_ERROR;
     }
 
-    max7219->spi     = (SPI_HandleTypeDef*)spi;
-    max7219->cs_port = (GPIO_TypeDef*)cs_port;
-    max7219->cs_pin  = cs_pin;
+    max7219->spi          = (SPI_HandleTypeDef*)spi;
+    max7219->cs_port      = (GPIO_TypeDef*)cs_port;
+    max7219->cs_pin       = cs_pin;
+    max7219->shadow_valid = false;
+    max7219->busy         = false;
+    max7219->callback     = NULL;
+
+    max7219_reset_stats(max7219);
 
     error_code = max7219_clear(max7219);
 
@@ -61,64 +68,137 @@ max7219_error_t max7219_init(max7219_t* max7219, const SPI_HandleTypeDef* spi, c
     return MAX7219_OK;
 }
 
-max7219_error_t max7219_clear(const max7219_t* max7219)
+max7219_error_t max7219_clear(max7219_t* max7219)
 {
     max7219_error_t error_code = MAX7219_OK;
 
-    error_code = max7219_send(max7219, MAX7219_COLUMN_0, 0x00);
+    error_code = max7219_send(max7219, MAX7219_ADR_DIGIT_0, 0x00);
 
     if (error_code != MAX7219_OK) {
         return error_code;
     }
 
-    error_code = max7219_send(max7219, MAX7219_COLUMN_1, 0x00);
+    error_code = max7219_send(max7219, MAX7219_ADR_DIGIT_1, 0x00);
 
     if (error_code != MAX7219_OK) {
         return error_code;
     }
 
-    error_code = max7219_send(max7219, MAX7219_COLUMN_2, 0x00);
+    error_code = max7219_send(max7219, MAX7219_ADR_DIGIT_2, 0x00);
 
     if (error_code != MAX7219_OK) {
         return error_code;
     }
 
-    error_code = max7219_send(max7219, MAX7219_COLUMN_3, 0x00);
+    error_code = max7219_send(max7219, MAX7219_ADR_DIGIT_3, 0x00);
 
     if (error_code != MAX7219_OK) {
         return error_code;
     }
 
-    error_code = max7219_send(max7219, MAX7219_COLUMN_4, 0x00);
+    error_code = max7219_send(max7219, MAX7219_ADR_DIGIT_4, 0x00);
 
     if (error_code != MAX7219_OK) {
         return error_code;
     }
 
-    error_code = max7219_send(max7219, MAX7219_COLUMN_5, 0x00);
+    error_code = max7219_send(max7219, MAX7219_ADR_DIGIT_5, 0x00);
 
     if (error_code != MAX7219_OK) {
         return error_code;
     }
 
-    error_code = max7219_send(max7219, MAX7219_COLUMN_6, 0x00);
+    error_code = max7219_send(max7219, MAX7219_ADR_DIGIT_6, 0x00);
 
     if (error_code != MAX7219_OK) {
         return error_code;
     }
 
-    error_code = max7219_send(max7219, MAX7219_COLUMN_7, 0x00);
+    error_code = max7219_send(max7219, MAX7219_ADR_DIGIT_7, 0x00);
 
     if (error_code != MAX7219_OK) {
         return error_code;
     }
 
+    max7219->shadow_valid = true;
+
+    return MAX7219_OK;
+}
+
+/**
+ * @brief Framebuffer index of a digit of a device in the cascade
+ *
+ * The devices are numbered in chain order (0 is the device next to the MCU), row by row of modules.
+ */
+static uint16_t fb_index(uint8_t device, uint8_t digit)
+{
+    uint8_t band   = device / MAX7219_DEVICES_X;
+    uint8_t column = (device % MAX7219_DEVICES_X) * MAX7219_DIGIT_AMOUNT + digit;
+
+    return band * MAX7219_COLUMN_AMOUNT + column;
+}
+
+/**
+ * @brief Transmit one word per device within a single CS window
+ *
+ * The first word shifted out ends up in the last device of the chain.
+ */
+static max7219_error_t transmit_window(max7219_t* max7219, uint16_t words[MAX7219_DEVICE_AMOUNT])
+{
+    while (max7219->busy) {
+        __WFI(); // Woken up by the DMA interrupts
+    }
+
+    HAL_GPIO_WritePin(max7219->cs_port, max7219->cs_pin, GPIO_PIN_RESET);
+    PROFILE_BUS(PROFILE_BUS_SPI1, MAX7219_DEVICE_AMOUNT * sizeof(uint16_t));
+
+    if (HAL_SPI_Transmit(max7219->spi, (uint8_t*)words, MAX7219_DEVICE_AMOUNT, HAL_MAX_DELAY) != HAL_OK) {
+        HAL_GPIO_WritePin(max7219->cs_port, max7219->cs_pin, GPIO_PIN_SET);
+        return MAX7219_COM_ERROR;
+    }
+
+    HAL_GPIO_WritePin(max7219->cs_port, max7219->cs_pin, GPIO_PIN_SET);
+
     return MAX7219_OK;
 }
 
-max7219_error_t max7219_send(const max7219_t* max7219, max7219_adr_t address, uint8_t data)
+/**
+ * @brief Check if a digit of any device differs from the values last sent
+ */
+static bool digit_changed(const max7219_t* max7219, const max7219_fb_t* fb, uint8_t digit)
+{
+    if (!max7219->shadow_valid) {
+        return true;
+    }
+
+    for (uint8_t device = 0; device < MAX7219_DEVICE_AMOUNT; device++) {
+        uint16_t idx = fb_index(device, digit);
+
+        if (max7219->shadow.columns[idx] != fb->columns[idx]) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Build the words of a digit for all devices and update the shadow copy accordingly
+ */
+static void build_window(max7219_t* max7219, const max7219_fb_t* fb, uint8_t digit, uint16_t words[MAX7219_DEVICE_AMOUNT])
+{
+    for (uint8_t device = 0; device < MAX7219_DEVICE_AMOUNT; device++) {
+        uint16_t idx = fb_index(device, digit);
+
+        words[MAX7219_DEVICE_AMOUNT - 1 - device] = ((MAX7219_ADR_DIGIT_0 + digit) << 8) | fb->columns[idx];
+        max7219->shadow.columns[idx]               = fb->columns[idx];
+    }
+}
+
+max7219_error_t max7219_send(max7219_t* max7219, max7219_adr_t address, uint8_t data)
 {
-    uint16_t word;
+    uint16_t        words[MAX7219_DEVICE_AMOUNT];
+    max7219_error_t error_code;
 
     if (max7219 == NULL) {
         return MAX7219_ERROR;
@@ -128,20 +208,27 @@ max7219_error_t max7219_send(const max7219_t* max7219, max7219_adr_t address, ui
         return MAX7219_WRONG_ADDRESS;
     }
 
-    HAL_GPIO_WritePin(max7219->cs_port, max7219->cs_pin, GPIO_PIN_RESET);
+    // Same register value for all devices of the cascade
+    for (uint8_t device = 0; device < MAX7219_DEVICE_AMOUNT; device++) {
+        words[device] = (address << 8) | data;
+    }
 
-    word = (address << 8) | data;
+    error_code = transmit_window(max7219, words);
 
-    if (HAL_SPI_Transmit(max7219->spi, (uint8_t*)&word, 1, HAL_MAX_DELAY) != HAL_OK) {
-        return MAX7219_COM_ERROR;
+    if (error_code != MAX7219_OK) {
+        return error_code;
     }
 
-    HAL_GPIO_WritePin(max7219->cs_port, max7219->cs_pin, GPIO_PIN_SET);
+    if ((address >= MAX7219_ADR_DIGIT_0) && (address <= MAX7219_ADR_DIGIT_7)) {
+        for (uint8_t device = 0; device < MAX7219_DEVICE_AMOUNT; device++) {
+            max7219->shadow.columns[fb_index(device, address - MAX7219_ADR_DIGIT_0)] = data;
+        }
+    }
 
     return MAX7219_OK;
 }
 
-static const uint8_t ROW_TO_SEGMENT[8] = {
+static const uint8_t ROW_TO_SEGMENT[MAX7219_SEGMENT_AMOUNT] = {
     [0] = MAX7219_SEGMENT_A,
     [1] = MAX7219_SEGMENT_B,
     [2] = MAX7219_SEGMENT_C,
@@ -152,29 +239,245 @@ static const uint8_t ROW_TO_SEGMENT[8] = {
     [7] = MAX7219_SEGMENT_DP,
 };
 
-max7219_error_t max7219_set_matrix(max7219_t* max7219, bool matrix[MAX7219_COLUMN_AMOUNT][MAX7219_ROW_AMOUNT])
+max7219_error_t max7219_set_matrix(max7219_t* max7219, const max7219_fb_t* fb)
 {
+    uint16_t words[MAX7219_DEVICE_AMOUNT];
+
     if (max7219 == NULL) {
         return MAX7219_ERROR;
     }
 
-    if (matrix == NULL) {
+    if (fb == NULL) {
         return MAX7219_ERROR;
     }
 
-    for (uint8_t column_idx = 0; column_idx < MAX7219_COLUMN_AMOUNT; column_idx++) {
-        uint8_t row = 0;
-
-        for (uint8_t row_idx = 0; row_idx < MAX7219_ROW_AMOUNT; row_idx++) {
-            if (matrix[column_idx][row_idx] == true) {
-                row |= ROW_TO_SEGMENT[row_idx];
-            }
+    for (uint8_t digit = 0; digit < MAX7219_DIGIT_AMOUNT; digit++) {
+        if (!digit_changed(max7219, fb, digit)) {
+            max7219->stats.words_skipped += MAX7219_DEVICE_AMOUNT;
+            continue;
         }
 
-        if (max7219_send(max7219, MAX7219_COLUMN_0 + column_idx, row) != MAX7219_OK) {
+        build_window(max7219, fb, digit, words);
+
+        if (transmit_window(max7219, words) != MAX7219_OK) {
+            max7219->shadow_valid = false; // Register content unknown, resend everything next time
             return MAX7219_ERROR;
         }
+
+        max7219->stats.words_sent += MAX7219_DEVICE_AMOUNT;
+    }
+
+    max7219->shadow_valid = true;
+
+    return MAX7219_OK;
+}
+
+max7219_error_t max7219_set_matrix_async(max7219_t* max7219, const max7219_fb_t* fb, max7219_callback_t callback)
+{
+    if (max7219 == NULL) {
+        return MAX7219_ERROR;
+    }
+
+    if (fb == NULL) {
+        return MAX7219_ERROR;
+    }
+
+    if (max7219->busy) {
+        return MAX7219_BUSY;
+    }
+
+    max7219->tx_amount = 0;
+    max7219->tx_idx    = 0;
+
+    for (uint8_t digit = 0; digit < MAX7219_DIGIT_AMOUNT; digit++) {
+        if (!digit_changed(max7219, fb, digit)) {
+            max7219->stats.words_skipped += MAX7219_DEVICE_AMOUNT;
+            continue;
+        }
+
+        build_window(max7219, fb, digit, max7219->tx_words[max7219->tx_amount++]);
+    }
+
+    max7219->shadow_valid = true;
+
+    if (max7219->tx_amount == 0) {
+        return MAX7219_UNCHANGED; // The callback is only called from interrupt context
+    }
+
+    max7219->callback = callback;
+    max7219->busy     = true;
+
+    HAL_GPIO_WritePin(max7219->cs_port, max7219->cs_pin, GPIO_PIN_RESET);
+    PROFILE_BUS(PROFILE_BUS_SPI1, MAX7219_DEVICE_AMOUNT * sizeof(uint16_t));
+
+    if (HAL_SPI_Transmit_DMA(max7219->spi, (uint8_t*)max7219->tx_words[0], MAX7219_DEVICE_AMOUNT) != HAL_OK) {
+        HAL_GPIO_WritePin(max7219->cs_port, max7219->cs_pin, GPIO_PIN_SET);
+        max7219->shadow_valid = false;
+        max7219->busy         = false;
+        return MAX7219_COM_ERROR;
+    }
+
+    return MAX7219_OK;
+}
+
+bool max7219_is_busy(const max7219_t* max7219)
+{
+    return (max7219 != NULL) && max7219->busy;
+}
+
+void max7219_spi_tx_complete(max7219_t* max7219)
+{
+    if ((max7219 == NULL) || !max7219->busy) {
+        return;
+    }
+
+    // Rising edge of CS latches the words of all devices
+    HAL_GPIO_WritePin(max7219->cs_port, max7219->cs_pin, GPIO_PIN_SET);
+
+    max7219->stats.words_sent += MAX7219_DEVICE_AMOUNT;
+    max7219->tx_idx++;
+
+    if (max7219->tx_idx < max7219->tx_amount) {
+        HAL_GPIO_WritePin(max7219->cs_port, max7219->cs_pin, GPIO_PIN_RESET);
+        PROFILE_BUS(PROFILE_BUS_SPI1, MAX7219_DEVICE_AMOUNT * sizeof(uint16_t));
+
+        if (HAL_SPI_Transmit_DMA(max7219->spi, (uint8_t*)max7219->tx_words[max7219->tx_idx], MAX7219_DEVICE_AMOUNT) == HAL_OK) {
+            return;
+        }
+
+        max7219_spi_error(max7219);
+        return;
+    }
+
+    max7219->busy = false;
+
+    if (max7219->callback != NULL) {
+        max7219->callback(max7219, MAX7219_OK);
+    }
+}
+
+void max7219_spi_error(max7219_t* max7219)
+{
+    if ((max7219 == NULL) || !max7219->busy) {
+        return;
+    }
+
+    HAL_GPIO_WritePin(max7219->cs_port, max7219->cs_pin, GPIO_PIN_SET);
+
+    max7219->shadow_valid = false; // Register content unknown, resend everything next time
+    max7219->busy         = false;
+
+    if (max7219->callback != NULL) {
+        max7219->callback(max7219, MAX7219_COM_ERROR);
+    }
+}
+
+max7219_error_t max7219_get_stats(const max7219_t* max7219, max7219_stats_t* stats)
+{
+    if ((max7219 == NULL) || (stats == NULL)) {
+        return MAX7219_ERROR;
+    }
+
+    *stats = max7219->stats;
+
+    return MAX7219_OK;
+}
+
+max7219_error_t max7219_reset_stats(max7219_t* max7219)
+{
+    if (max7219 == NULL) {
+        return MAX7219_ERROR;
     }
 
+    max7219->stats.words_sent    = 0;
+    max7219->stats.words_skipped = 0;
+
     return MAX7219_OK;
 }
+
+void max7219_fb_clear(max7219_fb_t* fb)
+{
+    for (uint16_t i = 0; i < MAX7219_FB_SIZE; i++) {
+        fb->columns[i] = 0x00;
+    }
+}
+
+void max7219_fb_set_pixel(max7219_fb_t* fb, uint8_t col, uint8_t row)
+{
+    if ((col >= MAX7219_COLUMN_AMOUNT) || (row >= MAX7219_ROW_AMOUNT)) {
+        return;
+    }
+
+    fb->columns[MAX7219_FB_INDEX(col, row)] |= ROW_TO_SEGMENT[row % MAX7219_SEGMENT_AMOUNT];
+}
+
+void max7219_fb_clear_pixel(max7219_fb_t* fb, uint8_t col, uint8_t row)
+{
+    if ((col >= MAX7219_COLUMN_AMOUNT) || (row >= MAX7219_ROW_AMOUNT)) {
+        return;
+    }
+
+    fb->columns[MAX7219_FB_INDEX(col, row)] &= (uint8_t)~ROW_TO_SEGMENT[row % MAX7219_SEGMENT_AMOUNT];
+}
+
+void max7219_fb_toggle_pixel(max7219_fb_t* fb, uint8_t col, uint8_t row)
+{
+    if ((col >= MAX7219_COLUMN_AMOUNT) || (row >= MAX7219_ROW_AMOUNT)) {
+        return;
+    }
+
+    fb->columns[MAX7219_FB_INDEX(col, row)] ^= ROW_TO_SEGMENT[row % MAX7219_SEGMENT_AMOUNT];
+}
+
+bool max7219_fb_test_pixel(const max7219_fb_t* fb, uint8_t col, uint8_t row)
+{
+    if ((col >= MAX7219_COLUMN_AMOUNT) || (row >= MAX7219_ROW_AMOUNT)) {
+        return false;
+    }
+
+    return (fb->columns[MAX7219_FB_INDEX(col, row)] & ROW_TO_SEGMENT[row % MAX7219_SEGMENT_AMOUNT]) != 0;
+}
+
+void max7219_fb_set_row(max7219_fb_t* fb, uint8_t row)
+{
+    if (row >= MAX7219_ROW_AMOUNT) {
+        return;
+    }
+
+    for (uint8_t col = 0; col < MAX7219_COLUMN_AMOUNT; col++) {
+        fb->columns[MAX7219_FB_INDEX(col, row)] |= ROW_TO_SEGMENT[row % MAX7219_SEGMENT_AMOUNT];
+    }
+}
+
+void max7219_fb_clear_row(max7219_fb_t* fb, uint8_t row)
+{
+    if (row >= MAX7219_ROW_AMOUNT) {
+        return;
+    }
+
+    for (uint8_t col = 0; col < MAX7219_COLUMN_AMOUNT; col++) {
+        fb->columns[MAX7219_FB_INDEX(col, row)] &= (uint8_t)~ROW_TO_SEGMENT[row % MAX7219_SEGMENT_AMOUNT];
+    }
+}
+
+void max7219_fb_set_column(max7219_fb_t* fb, uint8_t col)
+{
+    if (col >= MAX7219_COLUMN_AMOUNT) {
+        return;
+    }
+
+    for (uint8_t band = 0; band < MAX7219_DEVICES_Y; band++) {
+        fb->columns[band * MAX7219_COLUMN_AMOUNT + col] = 0xFF;
+    }
+}
+
+void max7219_fb_clear_column(max7219_fb_t* fb, uint8_t col)
+{
+    if (col >= MAX7219_COLUMN_AMOUNT) {
+        return;
+    }
+
+    for (uint8_t band = 0; band < MAX7219_DEVICES_Y; band++) {
+        fb->columns[band * MAX7219_COLUMN_AMOUNT + col] = 0x00;
+    }
+}
@@ -14,17 +14,47 @@
 #include <stdbool.h>
 #include <stdint.h>
 
-#define MAX7219_COLUMN_AMOUNT 8
-#define MAX7219_ROW_AMOUNT    8
+/*
+ * Cascade configuration: MAX7219_DEVICES_X modules next to each other and MAX7219_DEVICES_Y rows of modules, all
+ * daisy-chained on the same SPI bus and CS line (e.g., 4x1 for a 32x8 or 2x2 for a 16x16 display). The devices
+ * are chained row by row, the first device (next to the MCU) is the top left one.
+ */
+#ifndef MAX7219_DEVICES_X
+#define MAX7219_DEVICES_X 1
+#endif
+
+#ifndef MAX7219_DEVICES_Y
+#define MAX7219_DEVICES_Y 1
+#endif
+
+#define MAX7219_DEVICE_AMOUNT  (MAX7219_DEVICES_X * MAX7219_DEVICES_Y)
+#define MAX7219_DIGIT_AMOUNT   8 // Columns per device
+#define MAX7219_SEGMENT_AMOUNT 8 // Rows per device
+
+// Size of the virtual canvas spanning all devices
+#define MAX7219_COLUMN_AMOUNT (MAX7219_DEVICES_X * MAX7219_DIGIT_AMOUNT)
+#define MAX7219_ROW_AMOUNT    (MAX7219_DEVICES_Y * MAX7219_SEGMENT_AMOUNT)
+
+#define MAX7219_FB_SIZE            (MAX7219_DEVICES_Y * MAX7219_COLUMN_AMOUNT)                     // [bytes]
+#define MAX7219_FB_INDEX(col, row) (((row) / MAX7219_SEGMENT_AMOUNT) * MAX7219_COLUMN_AMOUNT + (col)) // Byte of a pixel
 
 /**
- * @brief MAX7219 handle
+ * @brief MAX7219 SPI traffic statistics of max7219_set_matrix()
  */
 typedef struct {
-    SPI_HandleTypeDef* spi;     // Pointer to SPI handle
-    GPIO_TypeDef*      cs_port; // SPI CS GPIO Port
-    uint16_t           cs_pin;  // SPI CS GPIO Pin
-} max7219_t;
+    uint32_t words_sent;    // Column words transmitted (one per device and CS window)
+    uint32_t words_skipped; // Column words skipped, because the column did not change on any device
+} max7219_stats_t;
+
+/**
+ * @brief MAX7219 packed framebuffer (virtual canvas spanning all devices of the cascade)
+ *
+ * One byte per column (i.e., digit register) and band of 8 rows, see MAX7219_FB_INDEX(). The rows are already
+ * mapped to their segment bits, so the framebuffer can be pushed to the MAX7219 as is.
+ */
+typedef struct {
+    uint8_t columns[MAX7219_FB_SIZE];
+} max7219_fb_t;
 
 /**
  * @brief MAX7219 error codes
@@ -34,8 +64,34 @@ typedef enum {
     MAX7219_ERROR,
     MAX7219_COM_ERROR,
     MAX7219_WRONG_ADDRESS,
+    MAX7219_BUSY,
+    MAX7219_UNCHANGED, // max7219_set_matrix_async(): nothing to send, no transfer started
 } max7219_error_t;
 
+struct max7219;
+
+/**
+ * @brief MAX7219 completion callback of max7219_set_matrix_async() (called from interrupt context)
+ */
+typedef void (*max7219_callback_t)(struct max7219* max7219, max7219_error_t error_code);
+
+/**
+ * @brief MAX7219 handle
+ */
+typedef struct max7219 {
+    SPI_HandleTypeDef* spi;                                                   // Pointer to SPI handle
+    GPIO_TypeDef*      cs_port;                                               // SPI CS GPIO Port
+    uint16_t           cs_pin;                                                // SPI CS GPIO Pin
+    max7219_fb_t       shadow;                                                // Last values sent to the digit registers
+    bool               shadow_valid;                                          // Shadow copy matches the digit registers
+    max7219_stats_t    stats;                                                 // SPI traffic statistics
+    uint16_t           tx_words[MAX7219_DIGIT_AMOUNT][MAX7219_DEVICE_AMOUNT]; // CS windows queued for the DMA transfer
+    uint8_t            tx_amount;                                             // Amount of queued CS windows
+    uint8_t            tx_idx;                                                // CS window currently being transmitted
+    volatile bool      busy;                                                  // DMA transfer in progress
+    max7219_callback_t callback;                                              // Completion callback of the DMA transfer
+} max7219_t;
+
 /**
  * @brief MAX7219 register addresses
  */
@@ -160,10 +216,10 @@ max7219_error_t max7219_init(max7219_t* max7219, const SPI_HandleTypeDef* spi, c
  *
  * @return max7219_error_t -- Error code
  */
-max7219_error_t max7219_clear(const max7219_t* max7219);
+max7219_error_t max7219_clear(max7219_t* max7219);
 
 /**
- * @brief MAX7219 send data over SPI
+ * @brief MAX7219 send data over SPI (the same register value to all devices of the cascade)
  *
  * @param[in] max7219 -- Pointer to MAX7219 handle
  * @param[in] address -- Address to be written to
@@ -171,8 +227,157 @@ max7219_error_t max7219_clear(const max7219_t* max7219);
  *
  * @return max7219_error_t -- Error code
  */
-max7219_error_t max7219_send(const max7219_t* max7219, max7219_adr_t address, uint8_t data);
+max7219_error_t max7219_send(max7219_t* max7219, max7219_adr_t address, uint8_t data);
+
+/**
+ * @brief MAX7219 push a framebuffer to the matrix LED
+ *
+ * Only the digits which differ from the last values sent are transmitted, one CS window per digit covering all
+ * devices of the cascade.
+ *
+ * @param[in] max7219 -- Pointer to MAX7219 handle
+ * @param[in] fb      -- Framebuffer to be shown
+ *
+ * @return max7219_error_t -- Error code
+ */
+max7219_error_t max7219_set_matrix(max7219_t* max7219, const max7219_fb_t* fb);
+
+/**
+ * @brief MAX7219 push a framebuffer to the matrix LED without blocking (SPI DMA)
+ *
+ * The changed columns are copied into the handle, so the framebuffer may be modified as soon as this function
+ * returns. Each digit is sent to all devices within one CS window, which is latched from the SPI transfer complete
+ * interrupt.
+ *
+ * @param[in] max7219  -- Pointer to MAX7219 handle
+ * @param[in] fb       -- Framebuffer to be shown
+ * @param[in] callback -- Called (in interrupt context) when the frame is shifted out, may be NULL. Only called if
+ *                         MAX7219_OK is returned.
+ *
+ * @return max7219_error_t -- Error code (MAX7219_BUSY if the previous frame is still being transmitted,
+ *                            MAX7219_UNCHANGED if the matrix already shows the framebuffer)
+ */
+max7219_error_t max7219_set_matrix_async(max7219_t* max7219, const max7219_fb_t* fb, max7219_callback_t callback);
+
+/**
+ * @brief MAX7219 check if an asynchronous transfer is in progress
+ *
+ * @param[in] max7219 -- Pointer to MAX7219 handle
+ *
+ * @return true  -- A frame is still being transmitted
+ * @return false -- The driver is idle
+ */
+bool max7219_is_busy(const max7219_t* max7219);
+
+/**
+ * @brief MAX7219 SPI transfer complete handler, to be called from HAL_SPI_TxCpltCallback()
+ *
+ * @param[in] max7219 -- Pointer to MAX7219 handle
+ */
+void max7219_spi_tx_complete(max7219_t* max7219);
+
+/**
+ * @brief MAX7219 SPI error handler, to be called from HAL_SPI_ErrorCallback()
+ *
+ * @param[in] max7219 -- Pointer to MAX7219 handle
+ */
+void max7219_spi_error(max7219_t* max7219);
 
-max7219_error_t max7219_set_matrix(max7219_t* max7219, bool matrix[MAX7219_COLUMN_AMOUNT][MAX7219_ROW_AMOUNT]);
+/**
+ * @brief MAX7219 get the SPI traffic statistics of max7219_set_matrix()
+ *
+ * @param[in] max7219 -- Pointer to MAX7219 handle
+ * @param[out] stats  -- Statistics
+ *
+ * @return max7219_error_t -- Error code
+ */
+max7219_error_t max7219_get_stats(const max7219_t* max7219, max7219_stats_t* stats);
+
+/**
+ * @brief MAX7219 reset the SPI traffic statistics
+ *
+ * @param[in] max7219 -- Pointer to MAX7219 handle
+ *
+ * @return max7219_error_t -- Error code
+ */
+max7219_error_t max7219_reset_stats(max7219_t* max7219);
+
+/**
+ * @brief Clear all pixels of a framebuffer
+ *
+ * @param[out] fb -- Framebuffer
+ */
+void max7219_fb_clear(max7219_fb_t* fb);
+
+/**
+ * @brief Set a single pixel of a framebuffer (out of range coordinates are ignored)
+ *
+ * @param[out] fb  -- Framebuffer
+ * @param[in] col  -- Column of the pixel
+ * @param[in] row  -- Row of the pixel
+ */
+void max7219_fb_set_pixel(max7219_fb_t* fb, uint8_t col, uint8_t row);
+
+/**
+ * @brief Clear a single pixel of a framebuffer (out of range coordinates are ignored)
+ *
+ * @param[out] fb  -- Framebuffer
+ * @param[in] col  -- Column of the pixel
+ * @param[in] row  -- Row of the pixel
+ */
+void max7219_fb_clear_pixel(max7219_fb_t* fb, uint8_t col, uint8_t row);
+
+/**
+ * @brief Toggle a single pixel of a framebuffer (out of range coordinates are ignored)
+ *
+ * @param[out] fb  -- Framebuffer
+ * @param[in] col  -- Column of the pixel
+ * @param[in] row  -- Row of the pixel
+ */
+void max7219_fb_toggle_pixel(max7219_fb_t* fb, uint8_t col, uint8_t row);
+
+/**
+ * @brief Test a single pixel of a framebuffer
+ *
+ * @param[in] fb   -- Framebuffer
+ * @param[in] col  -- Column of the pixel
+ * @param[in] row  -- Row of the pixel
+ *
+ * @return true  -- The pixel is set
+ * @return false -- The pixel is not set (or out of range)
+ */
+bool max7219_fb_test_pixel(const max7219_fb_t* fb, uint8_t col, uint8_t row);
+
+/**
+ * @brief Set all pixels of a row
+ *
+ * @param[out] fb  -- Framebuffer
+ * @param[in] row  -- Row to be set
+ */
+void max7219_fb_set_row(max7219_fb_t* fb, uint8_t row);
+
+/**
+ * @brief Clear all pixels of a row
+ *
+ * @param[out] fb  -- Framebuffer
+ * @param[in] row  -- Row to be cleared
+ */
+void max7219_fb_clear_row(max7219_fb_t* fb, uint8_t row);
+
+/**
+ * @brief Set all pixels of a column
+ *
+ * @param[out] fb  -- Framebuffer
+ * @param[in] col  -- Column to be set
+ */
+void max7219_fb_set_column(max7219_fb_t* fb, uint8_t col);
+
+/**
+ * @brief Clear all pixels of a column
+ *
+ * @param[out] fb  -- Framebuffer
+ * @param[in] col  -- Column to be cleared
+ */
+void max7219_fb_clear_column(max7219_fb_t* fb, uint8_t col);
 
 #endif /* MAX7219_H_ */
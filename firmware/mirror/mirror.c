@@ -0,0 +1,239 @@
+/**
+ * @file mirror.c
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ * The matrix is compared against a shadow of the last sent framebuffer. For the OLED, the dirty window of every page is
+ * tracked (the SSD1306 driver reports its drawing) and sent from the front of the window, one record at a time; the
+ * window shrinks by the columns which fitted into the record.
+ */
+
+#include "mirror.h"
+
+#if MIRROR_ENABLED
+
+#include "stm32f0xx_hal.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "ssd1306.h"
+#include "telemetry.h"
+
+#define PAGE_AMOUNT   (SSD1306_HEIGHT / 8)
+#define HEADER_SIZE   2   // Matrix: geometry, offset. OLED: page, first column
+#define DATA_SIZE     (TELEMETRY_MAX_PAYLOAD - HEADER_SIZE)
+#define PACK_RUN_MIN  3   // Shorter repetitions are cheaper as literals
+#define PACK_RUN_MAX  128 // Code 129
+#define PACK_COPY_MAX 128 // Code 127
+#define CLEAN         SSD1306_WIDTH
+
+_Static_assert(MAX7219_FB_SIZE <= 256, "The offset is a u8");
+_Static_assert((MAX7219_DEVICES_X < 16) && (MAX7219_DEVICES_Y < 16), "The geometry is packed into a u8");
+_Static_assert(SSD1306_WIDTH < 256, "The columns are u8 (SSD1306_WIDTH marks a clean page)");
+
+static max7219_fb_t     sent_matrix;
+static bool             sent_valid = false; // sent_matrix is what the host shows
+static volatile uint8_t oled_start[PAGE_AMOUNT];
+static volatile uint8_t oled_end[PAGE_AMOUNT];
+static uint32_t         refresh_tick = 0;
+static bool             initialized  = false;
+
+/**
+ * @brief Check if a record of the maximum size fits into the telemetry buffer without crowding out other records
+ */
+static bool room(void)
+{
+    return telemetry_get_free() >= (TELEMETRY_FRAME_SIZE(TELEMETRY_MAX_PAYLOAD) + MIRROR_RESERVE_BYTES);
+}
+
+/**
+ * @brief Send both displays completely
+ */
+static void refresh(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    for (uint8_t page = 0; page < PAGE_AMOUNT; page++) {
+        oled_start[page] = 0;
+        oled_end[page]   = SSD1306_WIDTH - 1;
+    }
+
+    __set_PRIMASK(primask);
+
+    sent_valid   = false;
+    refresh_tick = HAL_GetTick();
+}
+
+/**
+ * @brief PackBits: code 0..127: code + 1 literal bytes follow, code 129..255: the next byte repeats 257 - code times
+ *
+ * @param[in]  data       -- Input
+ * @param[in]  length     -- Input length [bytes]
+ * @param[out] out        -- Output
+ * @param[in]  size       -- Output size [bytes]
+ * @param[out] out_length -- Output length [bytes]
+ *
+ * @return uint8_t -- Encoded input bytes (as many as fit into the output)
+ */
+static uint8_t packbits(const uint8_t* data, uint8_t length, uint8_t* out, uint8_t size, uint8_t* out_length)
+{
+    uint8_t in   = 0;
+    uint8_t used = 0;
+
+    while ((in < length) && ((used + 2) <= size)) {
+        uint8_t run = 1;
+
+        while (((in + run) < length) && (run < PACK_RUN_MAX) && (data[in + run] == data[in])) {
+            run++;
+        }
+
+        if (run >= PACK_RUN_MIN) {
+            out[used++] = (uint8_t)(257 - run);
+            out[used++] = data[in];
+            in += run;
+            continue;
+        }
+
+        uint8_t code  = used++;
+        uint8_t count = 0;
+
+        // Up to the next run worth encoding
+        while (((in + count) < length) && (count < PACK_COPY_MAX) && (used < size)) {
+            if ((count > 0) && ((in + count + 2) < length) && (data[in + count] == data[in + count + 1])
+                && (data[in + count] == data[in + count + 2])) {
+                break;
+            }
+
+            out[used++] = data[in + count];
+            count++;
+        }
+
+        out[code] = (uint8_t)(count - 1);
+        in += count;
+    }
+
+    *out_length = used;
+
+    return in;
+}
+
+/**
+ * @brief Send the changed bytes of the matrix framebuffer
+ *
+ * @return bool -- true: all sent, false: the telemetry buffer is full
+ */
+static bool send_matrix(const max7219_fb_t* fb)
+{
+    uint8_t  payload[TELEMETRY_MAX_PAYLOAD];
+    uint16_t index = 0;
+
+    while (index < MAX7219_FB_SIZE) {
+        uint8_t length = 0;
+
+        if (sent_valid && (fb->columns[index] == sent_matrix.columns[index])) {
+            index++;
+            continue;
+        }
+
+        if (!room()) {
+            return false;
+        }
+
+        payload[0] = MAX7219_DEVICES_X | (MAX7219_DEVICES_Y << 4);
+        payload[1] = (uint8_t)index;
+
+        while (((index + length) < MAX7219_FB_SIZE) && (length < DATA_SIZE)
+               && (!sent_valid || (fb->columns[index + length] != sent_matrix.columns[index + length]))) {
+            payload[HEADER_SIZE + length] = fb->columns[index + length];
+            length++;
+        }
+
+        if (!telemetry_send(TELEMETRY_RECORD_MATRIX, payload, (uint8_t)(HEADER_SIZE + length))) {
+            return false;
+        }
+
+        memcpy(&sent_matrix.columns[index], &payload[HEADER_SIZE], length);
+        index += length;
+    }
+
+    sent_valid = true;
+
+    return true;
+}
+
+/**
+ * @brief Send the dirty windows of the OLED pages
+ */
+static void send_oled(void)
+{
+    const uint8_t* buffer = SSD1306_GetBuffer();
+    uint8_t        payload[TELEMETRY_MAX_PAYLOAD];
+
+    for (uint8_t page = 0; page < PAGE_AMOUNT; page++) {
+        while (oled_start[page] <= oled_end[page]) {
+            uint8_t start = oled_start[page];
+            uint8_t end   = oled_end[page];
+            uint8_t length;
+
+            if (!room()) {
+                return;
+            }
+
+            payload[0] = page;
+            payload[1] = start;
+
+            uint8_t columns = packbits(&buffer[page * SSD1306_WIDTH + start], (uint8_t)(end - start + 1),
+                                       &payload[HEADER_SIZE], DATA_SIZE, &length);
+
+            if (!telemetry_send(TELEMETRY_RECORD_OLED, payload, (uint8_t)(HEADER_SIZE + length))) {
+                return;
+            }
+
+            uint32_t primask = __get_PRIMASK();
+            __disable_irq();
+
+            // A window widened meanwhile (e.g., from interrupt context) is sent from its new start on
+            if (oled_start[page] == start) {
+                if ((start + columns) > oled_end[page]) {
+                    oled_start[page] = CLEAN;
+                    oled_end[page]   = 0;
+                } else {
+                    oled_start[page] = (uint8_t)(start + columns);
+                }
+            }
+
+            __set_PRIMASK(primask);
+        }
+    }
+}
+
+void mirror_update(const max7219_fb_t* fb)
+{
+    if (!initialized || ((HAL_GetTick() - refresh_tick) >= MIRROR_REFRESH_MS)) {
+        initialized = true;
+        refresh();
+    }
+
+    if (send_matrix(fb)) {
+        send_oled();
+    }
+}
+
+void mirror_oled_dirty(uint8_t col_start, uint8_t col_end, uint8_t page_start, uint8_t page_end)
+{
+    // Called with locked interrupts
+    for (uint8_t page = page_start; page <= page_end; page++) {
+        if (col_start < oled_start[page]) {
+            oled_start[page] = col_start;
+        }
+
+        if (col_end > oled_end[page]) {
+            oled_end[page] = col_end;
+        }
+    }
+}
+
+#endif /* MIRROR_ENABLED */
@@ -0,0 +1,57 @@
+/**
+ * @file mirror.h
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ */
+
+#ifndef MIRROR_H_
+#define MIRROR_H_
+
+#include <stdint.h>
+
+#include "max7219.h"
+
+/*
+ * Mirroring of the matrix and the OLED over the telemetry (tools/mirror.py shows both displays in a terminal). Only
+ * changes are sent: the changed bytes of the matrix framebuffer and the changed columns of the OLED pages, PackBits
+ * compressed. Compiled in with MIRROR_ENABLED set to 1 (e.g., -DMIRROR_ENABLED=1).
+ */
+#ifndef MIRROR_ENABLED
+#define MIRROR_ENABLED 0
+#endif
+
+#define MIRROR_RESERVE_BYTES 64   // Space in the telemetry buffer left for the other records [bytes]
+#define MIRROR_REFRESH_MS    5000 // Period of a full refresh, so a host can attach at any time [ms]
+
+#if MIRROR_ENABLED
+
+#define MIRROR_UPDATE(fb)                                           mirror_update(fb)
+#define MIRROR_OLED_DIRTY(col_start, col_end, page_start, page_end) mirror_oled_dirty(col_start, col_end, page_start, page_end)
+
+/**
+ * @brief Send the changes since the last call, as far as the telemetry buffer allows (the rest follows later)
+ *
+ * @param[in] fb -- Matrix framebuffer as pushed to the MAX7219
+ */
+void mirror_update(const max7219_fb_t* fb);
+
+/**
+ * @brief Mark a window of the OLED buffer as changed (called by the SSD1306 driver)
+ *
+ * @param[in] col_start  -- First column
+ * @param[in] col_end    -- Last column
+ * @param[in] page_start -- First page
+ * @param[in] page_end   -- Last page
+ */
+void mirror_oled_dirty(uint8_t col_start, uint8_t col_end, uint8_t page_start, uint8_t page_end);
+
+#else
+
+#define MIRROR_UPDATE(fb)                                           ((void)0)
+#define MIRROR_OLED_DIRTY(col_start, col_end, page_start, page_end) ((void)0)
+
+#endif /* MIRROR_ENABLED */
+
+#endif /* MIRROR_H_ */
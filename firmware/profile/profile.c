@@ -0,0 +1,168 @@
+/**
+ * @file profile.c
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ * The counter runs at PROFILE_TIMER_HZ in every clock profile, the prescaler follows PCLK. It does not count in stop
+ * mode, so a frame spanning a stop is measured too short.
+ */
+
+#include "profile.h"
+
+#if PROFILE_ENABLED
+
+#include "stm32f0xx_hal.h"
+
+#define TICKS_PER_US (PROFILE_TIMER_HZ / 1000000)
+
+typedef struct {
+    uint32_t start; // Counter at the begin marker
+    uint32_t count;
+    uint32_t min;   // [ticks]
+    uint32_t max;   // [ticks]
+    uint64_t total; // [ticks]
+} timing_t;
+
+static timing_t            scopes[PROFILE_SCOPE_AMOUNT];
+static timing_t            frames;
+static uint32_t            frame_budget_us  = 0;
+static uint32_t            frame_over_count = 0;
+static profile_bus_stats_t buses[PROFILE_BUS_AMOUNT];
+
+static uint32_t now(void)
+{
+    return TIM2->CNT;
+}
+
+static void timing_reset(timing_t* timing)
+{
+    *timing     = (timing_t) { 0 };
+    timing->min = UINT32_MAX;
+}
+
+static uint32_t timing_add(timing_t* timing)
+{
+    uint32_t duration = now() - timing->start; // Wrap-around safe
+
+    timing->count++;
+    timing->total += duration;
+
+    if (duration < timing->min) {
+        timing->min = duration;
+    }
+
+    if (duration > timing->max) {
+        timing->max = duration;
+    }
+
+    return duration;
+}
+
+static void timing_get(const timing_t* timing, profile_timing_t* out)
+{
+    out->count  = timing->count;
+    out->min_us = (timing->count > 0) ? (timing->min / TICKS_PER_US) : 0;
+    out->avg_us = (timing->count > 0) ? (uint32_t)(timing->total / timing->count / TICKS_PER_US) : 0;
+    out->max_us = timing->max / TICKS_PER_US;
+}
+
+void profile_init(void)
+{
+    __HAL_RCC_TIM2_CLK_ENABLE();
+
+    TIM2->CR1 = 0;
+    TIM2->ARR = UINT32_MAX;
+    TIM2->CNT = 0;
+
+    profile_clock_changed();
+    profile_reset();
+
+    TIM2->CR1 = TIM_CR1_CEN;
+}
+
+void profile_clock_changed(void)
+{
+    uint32_t count = TIM2->CNT;
+
+    TIM2->PSC = (HAL_RCC_GetPCLK1Freq() / PROFILE_TIMER_HZ) - 1;
+    TIM2->EGR = TIM_EGR_UG; // Load the prescaler now, this clears the counter
+    TIM2->CNT = count;
+}
+
+void profile_begin(profile_scope_t scope)
+{
+    scopes[scope].start = now();
+}
+
+void profile_end(profile_scope_t scope)
+{
+    timing_add(&scopes[scope]);
+}
+
+void profile_frame_begin(void)
+{
+    frames.start = now();
+}
+
+void profile_frame_end(uint32_t budget_ms)
+{
+    uint32_t duration = timing_add(&frames);
+
+    frame_budget_us = budget_ms * 1000;
+
+    if ((duration / TICKS_PER_US) > frame_budget_us) {
+        frame_over_count++;
+    }
+}
+
+void profile_bus(profile_bus_t bus, uint32_t bytes)
+{
+    // Also called from interrupt context (DMA chains)
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    buses[bus].transactions++;
+    buses[bus].bytes += bytes;
+
+    __set_PRIMASK(primask);
+}
+
+void profile_get_scope(profile_scope_t scope, profile_timing_t* timing)
+{
+    timing_get(&scopes[scope], timing);
+}
+
+void profile_get_frame(profile_frame_t* frame)
+{
+    timing_get(&frames, &frame->time);
+    frame->budget_us   = frame_budget_us;
+    frame->over_budget = frame_over_count;
+}
+
+void profile_get_bus(profile_bus_t bus, profile_bus_stats_t* stats)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    *stats = buses[bus];
+
+    __set_PRIMASK(primask);
+}
+
+void profile_reset(void)
+{
+    for (uint8_t i = 0; i < PROFILE_SCOPE_AMOUNT; i++) {
+        timing_reset(&scopes[i]);
+    }
+
+    timing_reset(&frames);
+    frame_budget_us  = 0;
+    frame_over_count = 0;
+
+    for (uint8_t i = 0; i < PROFILE_BUS_AMOUNT; i++) {
+        buses[i] = (profile_bus_stats_t) { 0 };
+    }
+}
+
+#endif /* PROFILE_ENABLED */
@@ -0,0 +1,158 @@
+/**
+ * @file profile.h
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ */
+
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+#include <stdint.h>
+
+/*
+ * Profiling on the free-running 32-bit TIM2 counter: execution time of named scopes, frame time against a budget and
+ * SPI1/I2C1 traffic. Everything compiles to nothing unless PROFILE_ENABLED is 1 (e.g., -DPROFILE_ENABLED=1), the
+ * stats can then be read with the debugger or the getters below.
+ */
+#ifndef PROFILE_ENABLED
+#define PROFILE_ENABLED 0
+#endif
+
+#define PROFILE_TIMER_HZ 8000000 // Counter clock, the same in every clock profile (wraps after ~536 s) [Hz]
+
+/**
+ * @brief Measured scopes
+ */
+typedef enum {
+    PROFILE_SCOPE_GAME_UPDATE,       // Update hook of the running game
+    PROFILE_SCOPE_GAME_RENDER,       // Render hook of the running game
+    PROFILE_SCOPE_MATRIX_PUSH,       // max7219_set_matrix_async() of the game loop (until the DMA is started)
+    PROFILE_SCOPE_OLED_UPDATE,       // SSD1306_UpdateScreen() with something to send
+    PROFILE_SCOPE_OLED_UPDATE_ASYNC, // SSD1306_UpdateScreenAsync() of the game loop (until the DMA is started)
+    PROFILE_SCOPE_SNAKE_STEP,        // One snake step
+    PROFILE_SCOPE_AMOUNT,            // Keep at end!
+} profile_scope_t;
+
+/**
+ * @brief Counted buses
+ */
+typedef enum {
+    PROFILE_BUS_SPI1, // MAX7219
+    PROFILE_BUS_I2C1, // SSD1306
+    PROFILE_BUS_AMOUNT, // Keep at end!
+} profile_bus_t;
+
+/**
+ * @brief Execution time statistics
+ */
+typedef struct {
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t avg_us;
+    uint32_t max_us;
+} profile_timing_t;
+
+/**
+ * @brief Frame time statistics
+ */
+typedef struct {
+    profile_timing_t time;
+    uint32_t         budget_us;   // Budget of the last frame
+    uint32_t         over_budget; // Frames which took longer than their budget
+} profile_frame_t;
+
+/**
+ * @brief Bus traffic statistics
+ */
+typedef struct {
+    uint32_t transactions; // HAL transfers (blocking or DMA)
+    uint32_t bytes;        // Bytes following the I2C address resp. within the SPI CS window
+} profile_bus_stats_t;
+
+#if PROFILE_ENABLED
+
+#define PROFILE_INIT()                  profile_init()
+#define PROFILE_CLOCK_CHANGED()         profile_clock_changed()
+#define PROFILE_BEGIN(scope)            profile_begin(scope)
+#define PROFILE_END(scope)              profile_end(scope)
+#define PROFILE_FRAME_BEGIN()           profile_frame_begin()
+#define PROFILE_FRAME_END(budget_ms)    profile_frame_end(budget_ms)
+#define PROFILE_BUS(bus, bytes)         profile_bus(bus, bytes)
+
+/**
+ * @brief Start TIM2 as free-running counter
+ */
+void profile_init(void);
+
+/**
+ * @brief Adapt the TIM2 prescaler to the new PCLK (call after every system clock change)
+ */
+void profile_clock_changed(void);
+
+/**
+ * @brief Mark the begin/end of a scope (scopes may nest, but a scope must not be re-entered)
+ *
+ * @param[in] scope -- Scope
+ */
+void profile_begin(profile_scope_t scope);
+void profile_end(profile_scope_t scope);
+
+/**
+ * @brief Mark the begin/end of a frame
+ *
+ * @param[in] budget_ms -- Time budget of the frame [ms]
+ */
+void profile_frame_begin(void);
+void profile_frame_end(uint32_t budget_ms);
+
+/**
+ * @brief Count a bus transaction
+ *
+ * @param[in] bus   -- Bus
+ * @param[in] bytes -- Transferred bytes
+ */
+void profile_bus(profile_bus_t bus, uint32_t bytes);
+
+/**
+ * @brief Get the statistics of a scope
+ *
+ * @param[in]  scope  -- Scope
+ * @param[out] timing -- Statistics
+ */
+void profile_get_scope(profile_scope_t scope, profile_timing_t* timing);
+
+/**
+ * @brief Get the frame statistics
+ *
+ * @param[out] frame -- Statistics
+ */
+void profile_get_frame(profile_frame_t* frame);
+
+/**
+ * @brief Get the traffic statistics of a bus
+ *
+ * @param[in]  bus   -- Bus
+ * @param[out] stats -- Statistics
+ */
+void profile_get_bus(profile_bus_t bus, profile_bus_stats_t* stats);
+
+/**
+ * @brief Reset all statistics (e.g., before measuring a change)
+ */
+void profile_reset(void);
+
+#else
+
+#define PROFILE_INIT()               ((void)0)
+#define PROFILE_CLOCK_CHANGED()      ((void)0)
+#define PROFILE_BEGIN(scope)         ((void)0)
+#define PROFILE_END(scope)           ((void)0)
+#define PROFILE_FRAME_BEGIN()        ((void)0)
+#define PROFILE_FRAME_END(budget_ms) ((void)0)
+#define PROFILE_BUS(bus, bytes)      ((void)0)
+
+#endif /* PROFILE_ENABLED */
+
+#endif /* PROFILE_H_ */
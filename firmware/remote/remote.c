@@ -0,0 +1,278 @@
+/**
+ * @file remote.c
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ * The UART interrupt only stores the received bytes in a ring buffer. The frames are decoded in the SysTick interrupt,
+ * which is also the producer of the input queue (see input.c), so the queue keeps a single producer. All interrupts
+ * run on the same priority, so the UART and SysTick interrupts never preempt each other.
+ */
+
+#include "remote.h"
+
+#if REMOTE_ENABLED
+
+#include <stdbool.h>
+
+#include "telemetry.h"
+
+#define BUFFER_MASK  (REMOTE_RX_BUFFER_SIZE - 1)
+#define INPUT_LENGTH 6 // type, button, pressed, tag, CRC
+
+_Static_assert((REMOTE_RX_BUFFER_SIZE & BUFFER_MASK) == 0, "REMOTE_RX_BUFFER_SIZE must be a power of two");
+_Static_assert(REMOTE_RX_BUFFER_SIZE <= 128, "Free-running 8-bit indices");
+_Static_assert(REMOTE_MAX_FRAME < 254, "One COBS block per frame");
+
+typedef struct {
+    uint16_t tag;
+    uint32_t received_ms;
+    uint32_t consumed_ms;
+} pending_t;
+
+static UART_HandleTypeDef* uart = NULL;
+
+// Ring buffer: head is only written by the UART interrupt, tail only by SysTick
+static uint8_t          rx_byte;
+static uint8_t          rx_ring[REMOTE_RX_BUFFER_SIZE];
+static volatile uint8_t rx_head = 0; // Free-running
+static volatile uint8_t rx_tail = 0; // Free-running
+static volatile bool    paused  = false;
+
+static uint8_t frame[REMOTE_MAX_FRAME]; // Frame being received (SysTick)
+static uint8_t frame_length   = 0;
+static bool    frame_overflow = false;
+
+static pending_t      pending[REMOTE_PENDING_AMOUNT]; // Main loop only
+static uint8_t        pending_amount = 0;
+static remote_stats_t stats          = { 0 };
+
+/**
+ * @brief CRC-8 (poly 0x07, init 0x00), as the telemetry
+ */
+static uint8_t crc8(const uint8_t* data, uint8_t length)
+{
+    uint8_t crc = 0;
+
+    for (uint8_t i = 0; i < length; i++) {
+        crc ^= data[i];
+
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+/**
+ * @brief Decode a COBS frame (without delimiter) in place
+ *
+ * @return uint8_t -- Decoded length (0: invalid frame) [bytes]
+ */
+static uint8_t cobs_decode(uint8_t* data, uint8_t length)
+{
+    uint8_t in  = 0;
+    uint8_t out = 0;
+
+    while (in < length) {
+        uint8_t code = data[in++];
+
+        if ((code == 0) || ((in + code - 1) > length)) {
+            return 0;
+        }
+
+        for (uint8_t i = 1; i < code; i++) {
+            data[out++] = data[in++];
+        }
+
+        if ((code < 0xFF) && (in < length)) {
+            data[out++] = 0;
+        }
+    }
+
+    return out;
+}
+
+static void start_receive(void)
+{
+    if (paused || (uart->RxState != HAL_UART_STATE_READY)) {
+        return;
+    }
+
+    if (HAL_UART_Receive_IT(uart, &rx_byte, 1) != HAL_OK) {
+        stats.uart_errors++; // Retried with the next error or resume
+    }
+}
+
+static void handle_input(const uint8_t* command)
+{
+    input_event_t event = {
+        .timestamp_ms = HAL_GetTick(),
+        .button       = (button_t)command[1],
+        .pressed      = (command[2] != 0),
+        .tag          = (uint16_t)(command[3] | (command[4] << 8)),
+    };
+
+    if (event.button >= BUTTON_NONE) {
+        stats.invalid_frames++;
+        return;
+    }
+
+    stats.commands++;
+
+    if (!input_inject(&event)) {
+        stats.dropped_events++;
+    }
+}
+
+static void handle_frame(void)
+{
+    uint8_t length = cobs_decode(frame, frame_length);
+
+    if ((length < 2) || (crc8(frame, length - 1) != frame[length - 1])) {
+        stats.invalid_frames++;
+        return;
+    }
+
+    if ((frame[0] == REMOTE_COMMAND_INPUT) && (length == INPUT_LENGTH)) {
+        handle_input(frame);
+    } else {
+        stats.invalid_frames++;
+    }
+}
+
+void remote_init(UART_HandleTypeDef* uart_in)
+{
+    uart           = uart_in;
+    rx_head        = 0;
+    rx_tail        = 0;
+    paused         = false;
+    frame_length   = 0;
+    frame_overflow = false;
+    pending_amount = 0;
+    stats          = (remote_stats_t) { 0 };
+
+    start_receive();
+}
+
+void remote_tick(void)
+{
+    while (rx_tail != rx_head) {
+        uint8_t byte = rx_ring[rx_tail & BUFFER_MASK];
+
+        rx_tail++;
+
+        if (byte != 0) {
+            if (frame_length < REMOTE_MAX_FRAME) {
+                frame[frame_length++] = byte;
+            } else {
+                frame_overflow = true;
+            }
+
+            continue;
+        }
+
+        if (frame_overflow) {
+            stats.invalid_frames++;
+        } else if (frame_length > 0) {
+            handle_frame();
+        }
+
+        frame_length   = 0;
+        frame_overflow = false;
+    }
+}
+
+void remote_pause(void)
+{
+    paused = true;
+
+    if (uart != NULL) {
+        HAL_UART_AbortReceive(uart);
+    }
+}
+
+void remote_resume(void)
+{
+    paused = false;
+
+    if (uart != NULL) {
+        start_receive();
+    }
+}
+
+void remote_uart_rx_complete(void)
+{
+    if ((uint8_t)(rx_head - rx_tail) < REMOTE_RX_BUFFER_SIZE) {
+        rx_ring[rx_head & BUFFER_MASK] = rx_byte;
+        rx_head++;
+    } else {
+        stats.rx_overflows++;
+    }
+
+    start_receive();
+}
+
+void remote_uart_error(void)
+{
+    if (uart == NULL) {
+        return;
+    }
+
+    if ((HAL_UART_GetError(uart) & (HAL_UART_ERROR_PE | HAL_UART_ERROR_NE | HAL_UART_ERROR_FE | HAL_UART_ERROR_ORE))
+        == 0) {
+        return; // TX error, handled by the telemetry
+    }
+
+    stats.uart_errors++;
+
+    // The frame is incomplete, the CRC drops it. An overrun aborts the reception.
+    start_receive();
+}
+
+void remote_input_consumed(const input_event_t* event)
+{
+    if (event->tag == 0) {
+        return;
+    }
+
+    if (pending_amount >= REMOTE_PENDING_AMOUNT) {
+        stats.dropped_reports++;
+        return;
+    }
+
+    pending[pending_amount++] = (pending_t) {
+        .tag         = event->tag,
+        .received_ms = event->timestamp_ms,
+        .consumed_ms = HAL_GetTick(),
+    };
+}
+
+void remote_frame_done(void)
+{
+    for (uint8_t i = 0; i < pending_amount; i++) {
+        uint8_t payload[10];
+
+        payload[0] = (uint8_t)pending[i].tag;
+        payload[1] = (uint8_t)(pending[i].tag >> 8);
+
+        for (uint8_t byte = 0; byte < 4; byte++) {
+            payload[2 + byte] = (uint8_t)(pending[i].received_ms >> (8 * byte));
+            payload[6 + byte] = (uint8_t)(pending[i].consumed_ms >> (8 * byte));
+        }
+
+        if (!telemetry_send(TELEMETRY_RECORD_REMOTE_INPUT, payload, sizeof(payload))) {
+            stats.dropped_reports++;
+        }
+    }
+
+    pending_amount = 0;
+}
+
+void remote_get_stats(remote_stats_t* stats_out)
+{
+    *stats_out = stats;
+}
+
+#endif /* REMOTE_ENABLED */
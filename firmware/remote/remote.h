@@ -0,0 +1,134 @@
+/**
+ * @file remote.h
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ */
+
+#ifndef REMOTE_H_
+#define REMOTE_H_
+
+#include "stm32f0xx_hal.h"
+
+#include <stdint.h>
+
+#include "input.h"
+
+/*
+ * Remote control over USART2 (RX direction of the telemetry UART), driven by tools/remote.py. Injected button events
+ * go into the input queue next to the real buttons. Compiled in with REMOTE_ENABLED set to 1 (e.g.,
+ * -DREMOTE_ENABLED=1).
+ *
+ * Command: type (u8), payload, CRC-8 (poly 0x07, init 0x00, over everything before)
+ * Frame:   COBS encoded command, terminated by 0x00 (as the telemetry records)
+ *
+ * Events with a tag are reported back with a TELEMETRY_RECORD_REMOTE_INPUT record once the first frame after the
+ * event has been pushed to the displays, for measuring the input-to-frame latency. Nothing is received in stop mode,
+ * and a command arriving during a clock switch (UART reconfiguration) is lost. Whoever re-initializes the UART (clock
+ * switch, wake-up from stop mode) has to wrap it with REMOTE_PAUSE() and REMOTE_RESUME(), HAL_UART_Init() ends the
+ * reception.
+ */
+#ifndef REMOTE_ENABLED
+#define REMOTE_ENABLED 0
+#endif
+
+#define REMOTE_RX_BUFFER_SIZE 32 // RX ring buffer, power of two, emptied every SysTick [bytes]
+#define REMOTE_MAX_FRAME      16 // Longest accepted frame (without delimiter) [bytes]
+#define REMOTE_PENDING_AMOUNT 4  // Tagged events reported per frame
+
+/**
+ * @brief Command types (keep in sync with tools/remote.py)
+ */
+typedef enum {
+    REMOTE_COMMAND_INPUT = 0x01, // button (u8, button_t), pressed (u8), tag (u16, 0: no report)
+} remote_command_t;
+
+/**
+ * @brief Remote control statistics
+ */
+typedef struct {
+    uint32_t commands;        // Valid commands
+    uint32_t invalid_frames;  // COBS, CRC, length or type errors
+    uint32_t rx_overflows;    // Bytes lost, because the RX ring buffer was full
+    uint32_t uart_errors;     // Framing, noise and overrun errors
+    uint32_t dropped_events;  // Events lost, because the input queue was full
+    uint32_t dropped_reports; // Tagged events which could not be reported
+} remote_stats_t;
+
+#if REMOTE_ENABLED
+
+#define REMOTE_INIT(uart)            remote_init(uart)
+#define REMOTE_TICK()                remote_tick()
+#define REMOTE_PAUSE()               remote_pause()
+#define REMOTE_RESUME()              remote_resume()
+#define REMOTE_UART_RX_COMPLETE()    remote_uart_rx_complete()
+#define REMOTE_UART_ERROR()          remote_uart_error()
+#define REMOTE_INPUT_CONSUMED(event) remote_input_consumed(event)
+#define REMOTE_FRAME_DONE()          remote_frame_done()
+
+/**
+ * @brief Initialize the remote control and start receiving (the UART must already be configured)
+ *
+ * @param[in] uart -- UART handle
+ */
+void remote_init(UART_HandleTypeDef* uart);
+
+/**
+ * @brief Decode the received frames into input events, to be called from the 1 ms SysTick interrupt
+ */
+void remote_tick(void);
+
+/**
+ * @brief Stop receiving (e.g., before the UART is reconfigured)
+ */
+void remote_pause(void);
+
+/**
+ * @brief Continue receiving after remote_pause()
+ */
+void remote_resume(void);
+
+/**
+ * @brief Byte received (call from HAL_UART_RxCpltCallback())
+ */
+void remote_uart_rx_complete(void);
+
+/**
+ * @brief UART error (call from HAL_UART_ErrorCallback()), restarts the reception if it was aborted
+ */
+void remote_uart_error(void);
+
+/**
+ * @brief An input event has been taken from the queue (main loop only)
+ *
+ * @param[in] event -- Event
+ */
+void remote_input_consumed(const input_event_t* event);
+
+/**
+ * @brief A frame has been pushed to the displays, reports the tagged events consumed before (main loop only)
+ */
+void remote_frame_done(void);
+
+/**
+ * @brief Get the statistics
+ *
+ * @param[out] stats -- Statistics
+ */
+void remote_get_stats(remote_stats_t* stats);
+
+#else
+
+#define REMOTE_INIT(uart)            ((void)0)
+#define REMOTE_TICK()                ((void)0)
+#define REMOTE_PAUSE()               ((void)0)
+#define REMOTE_RESUME()              ((void)0)
+#define REMOTE_UART_RX_COMPLETE()    ((void)0)
+#define REMOTE_UART_ERROR()          ((void)0)
+#define REMOTE_INPUT_CONSUMED(event) ((void)0)
+#define REMOTE_FRAME_DONE()          ((void)0)
+
+#endif /* REMOTE_ENABLED */
+
+#endif /* REMOTE_H_ */
@@ -0,0 +1,290 @@
+/**
+ * @file stm32f0xx_hal.h
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ * Host replacement of the STM32F0 HAL/CMSIS headers. Only the types, registers and functions used by the firmware
+ * modules are provided, they are implemented by the simulator (see sim_hal.c).
+ */
+
+#ifndef STM32F0XX_HAL_H_
+#define STM32F0XX_HAL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * HAL status and common definitions
+ */
+typedef enum {
+    HAL_OK      = 0x00U,
+    HAL_ERROR   = 0x01U,
+    HAL_BUSY    = 0x02U,
+    HAL_TIMEOUT = 0x03U,
+} HAL_StatusTypeDef;
+
+typedef enum {
+    HAL_TICK_FREQ_1KHZ    = 1U,
+    HAL_TICK_FREQ_DEFAULT = HAL_TICK_FREQ_1KHZ,
+} HAL_TickFreqTypeDef;
+
+#define HAL_MAX_DELAY 0xFFFFFFFFU
+
+extern volatile uint32_t   uwTick;
+extern HAL_TickFreqTypeDef uwTickFreq;
+extern uint32_t            SystemCoreClock;
+
+uint32_t HAL_GetTick(void);
+void     HAL_IncTick(void);
+void     HAL_Delay(uint32_t Delay); // Provided by power.c
+void     HAL_SuspendTick(void);
+void     HAL_ResumeTick(void);
+
+/*
+ * Core (CMSIS)
+ */
+typedef struct {
+    volatile uint32_t CTRL;
+    volatile uint32_t LOAD;
+    volatile uint32_t VAL;
+    volatile uint32_t CALIB;
+} SysTick_Type;
+
+typedef struct {
+    volatile uint32_t CPUID;
+    volatile uint32_t ICSR;
+} SCB_Type;
+
+#define SCB_ICSR_PENDSTSET_Msk (1UL << 26)
+
+extern SysTick_Type sim_systick;
+extern SCB_Type     sim_scb;
+
+#define SysTick (&sim_systick)
+#define SCB     (&sim_scb)
+
+void     __WFI(void);
+void     __disable_irq(void);
+void     __enable_irq(void);
+uint32_t __get_PRIMASK(void);
+void     __set_PRIMASK(uint32_t priMask);
+
+/*
+ * GPIO
+ */
+typedef struct {
+    volatile uint32_t IDR; // Input levels (driven by the simulator)
+    volatile uint32_t ODR; // Output levels
+} GPIO_TypeDef;
+
+typedef enum {
+    GPIO_PIN_RESET = 0U,
+    GPIO_PIN_SET,
+} GPIO_PinState;
+
+#define GPIO_PIN_0  ((uint16_t)0x0001)
+#define GPIO_PIN_1  ((uint16_t)0x0002)
+#define GPIO_PIN_2  ((uint16_t)0x0004)
+#define GPIO_PIN_3  ((uint16_t)0x0008)
+#define GPIO_PIN_4  ((uint16_t)0x0010)
+#define GPIO_PIN_5  ((uint16_t)0x0020)
+#define GPIO_PIN_6  ((uint16_t)0x0040)
+#define GPIO_PIN_7  ((uint16_t)0x0080)
+#define GPIO_PIN_8  ((uint16_t)0x0100)
+#define GPIO_PIN_9  ((uint16_t)0x0200)
+#define GPIO_PIN_10 ((uint16_t)0x0400)
+#define GPIO_PIN_11 ((uint16_t)0x0800)
+#define GPIO_PIN_12 ((uint16_t)0x1000)
+#define GPIO_PIN_13 ((uint16_t)0x2000)
+#define GPIO_PIN_14 ((uint16_t)0x4000)
+#define GPIO_PIN_15 ((uint16_t)0x8000)
+
+extern GPIO_TypeDef sim_gpioa;
+extern GPIO_TypeDef sim_gpiob;
+extern GPIO_TypeDef sim_gpiof;
+
+#define GPIOA (&sim_gpioa)
+#define GPIOB (&sim_gpiob)
+#define GPIOF (&sim_gpiof)
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin);
+void          HAL_GPIO_WritePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+void          HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin);
+
+/*
+ * RCC, FLASH latency, PWR
+ */
+#define RCC_OSCILLATORTYPE_HSI48 0x00000020U
+#define RCC_HSI48_OFF            0x00U
+#define RCC_HSI48_ON             0x01U
+#define RCC_PLL_NONE             0x00U
+
+#define RCC_CLOCKTYPE_SYSCLK 0x00000001U
+#define RCC_CLOCKTYPE_HCLK   0x00000002U
+#define RCC_CLOCKTYPE_PCLK1  0x00000004U
+
+#define RCC_SYSCLKSOURCE_HSI   0x00000000U
+#define RCC_SYSCLKSOURCE_HSI48 0x00000003U
+#define RCC_SYSCLK_DIV1        0x00000000U
+#define RCC_HCLK_DIV1          0x00000000U
+
+#define FLASH_LATENCY_0 0x00000000U
+#define FLASH_LATENCY_1 0x00000001U
+
+#define HSI_VALUE   8000000U
+#define HSI48_VALUE 48000000U
+
+typedef struct {
+    uint32_t PLLState;
+} RCC_PLLInitTypeDef;
+
+typedef struct {
+    uint32_t           OscillatorType;
+    uint32_t           HSI48State;
+    RCC_PLLInitTypeDef PLL;
+} RCC_OscInitTypeDef;
+
+typedef struct {
+    uint32_t ClockType;
+    uint32_t SYSCLKSource;
+    uint32_t AHBCLKDivider;
+    uint32_t APB1CLKDivider;
+} RCC_ClkInitTypeDef;
+
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef* RCC_OscInitStruct);
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef* RCC_ClkInitStruct, uint32_t FLatency);
+uint32_t          HAL_RCC_GetPCLK1Freq(void);
+
+#define __HAL_RCC_PWR_CLK_ENABLE()          ((void)0)
+#define __HAL_FLASH_PREFETCH_BUFFER_ENABLE() ((void)0)
+
+#define PWR_LOWPOWERREGULATOR_ON 0x00000001U
+#define PWR_STOPENTRY_WFI        0x01U
+
+void HAL_PWR_EnterSTOPMode(uint32_t Regulator, uint8_t STOPEntry);
+
+/*
+ * TIM2 (profile.c), counts the virtual time. The firmware code itself runs in zero time, so only waits and blocking
+ * transfers are measured.
+ */
+#define TIM_CR1_CEN 0x00000001U
+#define TIM_EGR_UG  0x00000001U
+
+typedef struct {
+    volatile uint32_t CR1;
+    volatile uint32_t EGR;
+    volatile uint32_t CNT;
+    volatile uint32_t PSC;
+    volatile uint32_t ARR;
+} TIM_TypeDef;
+
+TIM_TypeDef* sim_tim2(void); // Brings the counter up to the virtual time
+
+#define TIM2                        (sim_tim2())
+#define __HAL_RCC_TIM2_CLK_ENABLE() ((void)0)
+
+/*
+ * SPI
+ */
+#define SPI_CR1_BR_0              0x00000008U
+#define SPI_BAUDRATEPRESCALER_2   0x00000000U
+#define SPI_BAUDRATEPRESCALER_256 0x00000038U
+
+typedef struct {
+    uint32_t BaudRatePrescaler;
+} SPI_InitTypeDef;
+
+typedef struct {
+    SPI_InitTypeDef Init;
+} SPI_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef* hspi);
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size);
+void              HAL_SPI_TxCpltCallback(SPI_HandleTypeDef* hspi);
+void              HAL_SPI_ErrorCallback(SPI_HandleTypeDef* hspi);
+
+/*
+ * I2C
+ */
+#define I2C_MEMADD_SIZE_8BIT 0x00000001U
+
+typedef struct {
+    uint32_t Timing;
+} I2C_InitTypeDef;
+
+typedef struct {
+    I2C_InitTypeDef Init;
+} I2C_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint32_t Trials, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint8_t* pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t* pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Write_DMA(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t* pData, uint16_t Size);
+void              HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef* hi2c);
+void              HAL_I2C_ErrorCallback(I2C_HandleTypeDef* hi2c);
+
+/*
+ * UART
+ */
+#define HAL_UART_ERROR_NONE 0x00U
+#define HAL_UART_ERROR_PE   0x01U
+#define HAL_UART_ERROR_NE   0x02U
+#define HAL_UART_ERROR_FE   0x04U
+#define HAL_UART_ERROR_ORE  0x08U
+#define HAL_UART_ERROR_DMA  0x10U
+
+typedef uint32_t HAL_UART_StateTypeDef;
+
+#define HAL_UART_STATE_READY   0x20U
+#define HAL_UART_STATE_BUSY_RX 0x22U
+
+typedef struct {
+    uint32_t BaudRate;
+} UART_InitTypeDef;
+
+typedef struct {
+    UART_InitTypeDef               Init;
+    uint8_t*                       pRxBuffPtr;
+    uint16_t                       RxXferCount;
+    volatile HAL_UART_StateTypeDef RxState;
+    volatile uint32_t              ErrorCode;
+} UART_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef* huart);
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef* huart, const uint8_t* pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef* huart);
+uint32_t          HAL_UART_GetError(const UART_HandleTypeDef* huart);
+void              HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart);
+void              HAL_UART_RxCpltCallback(UART_HandleTypeDef* huart);
+void              HAL_UART_ErrorCallback(UART_HandleTypeDef* huart);
+
+/*
+ * FLASH (the storage pages are mapped to a host array, see sim_flash)
+ */
+#define FLASH_TYPEPROGRAM_HALFWORD 0x01U
+#define FLASH_TYPEERASE_PAGES      0x00U
+
+#define SIM_FLASH_PAGE_SIZE 1024U
+#define SIM_FLASH_SIZE      (2 * SIM_FLASH_PAGE_SIZE)
+
+extern uint8_t sim_flash[SIM_FLASH_SIZE];
+
+#define STORAGE_PAGE_0_ADDRESS           ((uintptr_t)&sim_flash[0])
+#define STORAGE_PAGE_1_ADDRESS           ((uintptr_t)&sim_flash[SIM_FLASH_PAGE_SIZE])
+#define STORAGE_LEGACY_HIGHSCORE_ADDRESS ((uintptr_t)&sim_flash[SIM_FLASH_PAGE_SIZE + 0x300]) // 0x08007F00
+
+typedef struct {
+    uint32_t TypeErase;
+    uint32_t PageAddress;
+    uint32_t NbPages;
+} FLASH_EraseInitTypeDef;
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_Lock(void);
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data);
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef* pEraseInit, uint32_t* PageError);
+
+#endif /* STM32F0XX_HAL_H_ */
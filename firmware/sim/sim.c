@@ -0,0 +1,689 @@
+/**
+ * @file sim.c
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ * Interrupts are raised at their virtual time and served at once unless PRIMASK is set, in which case they stay
+ * pending (and wake up WFI) until the mask is cleared. All interrupts share one priority, as on the target.
+ *
+ * Script format (one command per line, '#' starts a comment):
+ *   <time> press|release <button>
+ *   <time> tap <button> [hold_ms]
+ *   <time> remote press|release <button>
+ *   <time> remote tap <button> [hold_ms]
+ *   <time> dump
+ *   <time> end
+ * <time> is given in ms since the start, or relative to the previous command with a leading '+'. Buttons: up, down,
+ * left, right, center. remote sends the event as a command over USART2 (builds with REMOTE_ENABLED), the events are
+ * tagged 1, 2, 3, ... in script order.
+ */
+
+#include "sim.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "app.h"
+#include "input.h"
+#include "main.h"
+#include "remote.h"
+#include "sim_max7219.h"
+#include "sim_ssd1306.h"
+
+#define SCRIPT_MAX_EVENTS  1024
+#define SCRIPT_DEFAULT_TAP 60 // Hold time of a tap [ms]
+#define RX_BUFFER_SIZE     256 // Bytes on the way to USART2 (power of two)
+
+extern SPI_HandleTypeDef  hspi1;
+extern I2C_HandleTypeDef  hi2c1;
+extern UART_HandleTypeDef huart2;
+
+typedef enum {
+    EVENT_PRESS,
+    EVENT_RELEASE,
+    EVENT_REMOTE_PRESS,
+    EVENT_REMOTE_RELEASE,
+    EVENT_DUMP,
+    EVENT_END,
+} event_type_t;
+
+typedef struct {
+    uint64_t     time_us;
+    uint16_t     order; // Keeps the script order of simultaneous events
+    event_type_t type;
+    button_t     button;
+} event_t;
+
+typedef struct {
+    const char*   name;
+    GPIO_TypeDef* port;
+    uint16_t      pin;
+} button_pin_t;
+
+/* clang-format off */
+
+static const button_pin_t BUTTON_PINS[BUTTON_NONE] = {
+    [BUTTON_UP]     = { .name = "up",     .port = BUTTON_UP_GPIO_Port,     .pin = BUTTON_UP_Pin     },
+    [BUTTON_DOWN]   = { .name = "down",   .port = BUTTON_DOWN_GPIO_Port,   .pin = BUTTON_DOWN_Pin   },
+    [BUTTON_LEFT]   = { .name = "left",   .port = BUTTON_LEFT_GPIO_Port,   .pin = BUTTON_LEFT_Pin   },
+    [BUTTON_RIGHT]  = { .name = "right",  .port = BUTTON_RIGHT_GPIO_Port,  .pin = BUTTON_RIGHT_Pin  },
+    [BUTTON_CENTER] = { .name = "center", .port = BUTTON_CENTER_GPIO_Port, .pin = BUTTON_CENTER_Pin },
+};
+
+/* clang-format on */
+
+static sim_options_t options;
+static sim_stats_t   stats = { 0 };
+
+static uint64_t now_us = 0;
+static uint64_t end_us = 0;
+
+static bool     tick_enabled = true;
+static uint64_t next_tick_us = SIM_US_PER_MS;
+
+static bool     dma_active[SIM_DMA_AMOUNT]  = { false };
+static uint64_t dma_done_us[SIM_DMA_AMOUNT] = { 0 };
+
+static bool     pending_tick                = false;
+static bool     pending_dma[SIM_DMA_AMOUNT] = { false };
+static bool     pending_rx                  = false;
+static uint16_t pending_exti                = 0; // EXTI lines (pin masks)
+static uint32_t primask                     = 0;
+static bool     in_interrupt                = false;
+
+static FILE* uart_file = NULL;
+
+static uint8_t  rx_bytes[RX_BUFFER_SIZE]; // Remote commands on the wire
+static uint16_t rx_head    = 0;
+static uint16_t rx_tail    = 0;
+static uint64_t next_rx_us = 0; // Arrival of the byte at rx_tail
+static uint16_t remote_tag = 0;
+
+static event_t  events[SCRIPT_MAX_EVENTS];
+static uint16_t event_amount = 0;
+static uint16_t event_next   = 0;
+
+static void fail(const char* message, const char* detail)
+{
+    fprintf(stderr, "sim: %s%s%s\n", message, (detail != NULL) ? ": " : "", (detail != NULL) ? detail : "");
+    exit(EXIT_FAILURE);
+}
+
+static int compare_events(const void* a, const void* b)
+{
+    const event_t* event_a = a;
+    const event_t* event_b = b;
+
+    if (event_a->time_us != event_b->time_us) {
+        return (event_a->time_us < event_b->time_us) ? -1 : 1;
+    }
+
+    return (int)event_a->order - (int)event_b->order;
+}
+
+static void add_event(uint64_t time_ms, event_type_t type, button_t button)
+{
+    if (event_amount >= SCRIPT_MAX_EVENTS) {
+        fail("too many script events", NULL);
+    }
+
+    events[event_amount] = (event_t) {
+        .time_us = time_ms * SIM_US_PER_MS,
+        .order   = event_amount,
+        .type    = type,
+        .button  = button,
+    };
+
+    event_amount++;
+}
+
+static button_t parse_button(const char* name, unsigned line)
+{
+    for (uint8_t i = 0; i < BUTTON_NONE; i++) {
+        if ((name != NULL) && (strcmp(name, BUTTON_PINS[i].name) == 0)) {
+            return (button_t)i;
+        }
+    }
+
+    fprintf(stderr, "sim: script line %u: unknown button '%s'\n", line, (name != NULL) ? name : "");
+    exit(EXIT_FAILURE);
+}
+
+static void add_remote_event(uint64_t time_ms, const char* action, const char* button, const char* hold, unsigned line)
+{
+    if ((action != NULL) && (strcmp(action, "press") == 0)) {
+        add_event(time_ms, EVENT_REMOTE_PRESS, parse_button(button, line));
+    } else if ((action != NULL) && (strcmp(action, "release") == 0)) {
+        add_event(time_ms, EVENT_REMOTE_RELEASE, parse_button(button, line));
+    } else if ((action != NULL) && (strcmp(action, "tap") == 0)) {
+        button_t tapped = parse_button(button, line);
+
+        add_event(time_ms, EVENT_REMOTE_PRESS, tapped);
+        add_event(time_ms + ((hold != NULL) ? strtoull(hold, NULL, 10) : SCRIPT_DEFAULT_TAP), EVENT_REMOTE_RELEASE,
+                  tapped);
+    } else {
+        fprintf(stderr, "sim: script line %u: unknown remote action '%s'\n", line, (action != NULL) ? action : "");
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void load_script(const char* path)
+{
+    FILE*    file = fopen(path, "r");
+    char     text[256];
+    unsigned line    = 0;
+    uint64_t time_ms = 0;
+
+    if (file == NULL) {
+        fail("cannot open script", path);
+    }
+
+    while (fgets(text, sizeof(text), file) != NULL) {
+        char* comment = strchr(text, '#');
+
+        line++;
+
+        if (comment != NULL) {
+            *comment = '\0';
+        }
+
+        char* time    = strtok(text, " \t\r\n");
+        char* command = strtok(NULL, " \t\r\n");
+        char* button  = strtok(NULL, " \t\r\n");
+        char* hold    = strtok(NULL, " \t\r\n");
+        char* extra   = strtok(NULL, " \t\r\n");
+
+        if (time == NULL) {
+            continue; // Empty line
+        }
+
+        if (command == NULL) {
+            fprintf(stderr, "sim: script line %u: command missing\n", line);
+            exit(EXIT_FAILURE);
+        }
+
+        if (time[0] == '+') {
+            time_ms += strtoull(&time[1], NULL, 10);
+        } else {
+            time_ms = strtoull(time, NULL, 10);
+        }
+
+        if (strcmp(command, "press") == 0) {
+            add_event(time_ms, EVENT_PRESS, parse_button(button, line));
+        } else if (strcmp(command, "release") == 0) {
+            add_event(time_ms, EVENT_RELEASE, parse_button(button, line));
+        } else if (strcmp(command, "tap") == 0) {
+            button_t tapped = parse_button(button, line);
+
+            add_event(time_ms, EVENT_PRESS, tapped);
+            add_event(time_ms + ((hold != NULL) ? strtoull(hold, NULL, 10) : SCRIPT_DEFAULT_TAP), EVENT_RELEASE, tapped);
+        } else if (strcmp(command, "remote") == 0) {
+            add_remote_event(time_ms, button, hold, extra, line); // remote <action> <button> [hold_ms]
+        } else if (strcmp(command, "dump") == 0) {
+            add_event(time_ms, EVENT_DUMP, BUTTON_NONE);
+        } else if (strcmp(command, "end") == 0) {
+            add_event(time_ms, EVENT_END, BUTTON_NONE);
+        } else {
+            fprintf(stderr, "sim: script line %u: unknown command '%s'\n", line, command);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    fclose(file);
+
+    qsort(events, event_amount, sizeof(events[0]), compare_events);
+}
+
+static void load_flash(const char* path)
+{
+    FILE* file;
+
+    memset(sim_flash, 0xFF, sizeof(sim_flash)); // Erased
+
+    // Flash addresses are 32 bit on the target, the HAL stub restores the upper bits from sim_flash
+    if ((((uint64_t)(uintptr_t)sim_flash) >> 32) != (((uint64_t)(uintptr_t)&sim_flash[SIM_FLASH_SIZE - 1]) >> 32)) {
+        fail("flash array crosses a 4 GiB boundary", NULL);
+    }
+
+    if ((path == NULL) || ((file = fopen(path, "rb")) == NULL)) {
+        return; // First run
+    }
+
+    if (fread(sim_flash, 1, sizeof(sim_flash), file) != sizeof(sim_flash)) {
+        fclose(file);
+        fail("flash image has the wrong size", path);
+    }
+
+    fclose(file);
+}
+
+static void save_flash(const char* path)
+{
+    FILE* file;
+
+    if ((path == NULL) || ((file = fopen(path, "wb")) == NULL)) {
+        return;
+    }
+
+    fwrite(sim_flash, 1, sizeof(sim_flash), file);
+    fclose(file);
+}
+
+static void rx_put(uint8_t byte)
+{
+    if ((uint16_t)(rx_head - rx_tail) >= RX_BUFFER_SIZE) {
+        fail("too many remote commands at once", NULL);
+    }
+
+    if (rx_head == rx_tail) {
+        next_rx_us = now_us + sim_uart_byte_time_us(); // Line idle
+    }
+
+    rx_bytes[rx_head++ & (RX_BUFFER_SIZE - 1)] = byte;
+}
+
+/**
+ * @brief Put a remote input command on the wire (see remote.h for the format)
+ */
+static void send_remote_input(button_t button, bool pressed)
+{
+    uint8_t command[6] = { REMOTE_COMMAND_INPUT, (uint8_t)button, pressed, 0, 0, 0 };
+    uint8_t crc        = 0;
+    uint8_t start      = 0;
+
+    remote_tag++;
+    command[3] = (uint8_t)remote_tag;
+    command[4] = (uint8_t)(remote_tag >> 8);
+
+    for (uint8_t i = 0; i < 5; i++) {
+        crc ^= command[i];
+
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+
+    command[5] = crc;
+
+    // COBS: every zero is replaced by the distance to the next one
+    for (uint8_t i = 0; i <= sizeof(command); i++) {
+        if ((i == sizeof(command)) || (command[i] == 0)) {
+            rx_put((uint8_t)(i - start + 1));
+
+            for (uint8_t j = start; j < i; j++) {
+                rx_put(command[j]);
+            }
+
+            start = i + 1;
+        }
+    }
+
+    rx_put(0x00);
+}
+
+/**
+ * @brief Serve the pending interrupts (see stm32f0xx_it.c for the handlers on the target)
+ */
+static void dispatch(void)
+{
+    if (in_interrupt || (primask != 0)) {
+        return;
+    }
+
+    in_interrupt = true;
+
+    for (;;) {
+        if (pending_exti != 0) {
+            uint16_t line = pending_exti & (uint16_t)(-pending_exti); // Lowest line first
+
+            pending_exti &= (uint16_t)~line;
+            HAL_GPIO_EXTI_Callback(line);
+        } else if (pending_tick) {
+            pending_tick = false;
+            SCB->ICSR &= ~SCB_ICSR_PENDSTSET_Msk;
+            stats.ticks++;
+
+            // SysTick_Handler()
+            HAL_IncTick();
+            input_tick();
+            REMOTE_TICK();
+            app_beep_tick();
+        } else if (pending_dma[SIM_DMA_SPI]) {
+            pending_dma[SIM_DMA_SPI] = false;
+            HAL_SPI_TxCpltCallback(&hspi1);
+        } else if (pending_dma[SIM_DMA_I2C]) {
+            pending_dma[SIM_DMA_I2C] = false;
+            HAL_I2C_MemTxCpltCallback(&hi2c1);
+        } else if (pending_dma[SIM_DMA_UART]) {
+            pending_dma[SIM_DMA_UART] = false;
+            HAL_UART_TxCpltCallback(&huart2);
+        } else if (pending_rx) {
+            pending_rx = false;
+            HAL_UART_RxCpltCallback(&huart2);
+        } else {
+            break;
+        }
+    }
+
+    in_interrupt = false;
+}
+
+static void set_time(uint64_t time_us)
+{
+    uint32_t reload  = SysTick->LOAD + 1;
+    uint64_t elapsed = time_us - (next_tick_us - SIM_US_PER_MS); // Since the last reload
+
+    now_us = time_us;
+
+    // Down counter, reaches 0 at the next tick
+    SysTick->VAL = (uint32_t)(reload - 1 - ((elapsed % SIM_US_PER_MS) * reload) / SIM_US_PER_MS);
+}
+
+static uint64_t next_event_us(bool stop)
+{
+    uint64_t next = end_us;
+
+    if (event_next < event_amount) {
+        next = (events[event_next].time_us < next) ? events[event_next].time_us : next;
+    }
+
+    if ((rx_head != rx_tail) && (next_rx_us < next)) {
+        next = next_rx_us; // Also in stop mode, the bytes are lost there
+    }
+
+    if (stop) {
+        return next; // Only the buttons (EXTI) run in stop mode
+    }
+
+    if (tick_enabled && (next_tick_us < next)) {
+        next = next_tick_us;
+    }
+
+    for (uint8_t i = 0; i < SIM_DMA_AMOUNT; i++) {
+        if (dma_active[i] && (dma_done_us[i] < next)) {
+            next = dma_done_us[i];
+        }
+    }
+
+    return next;
+}
+
+/**
+ * @brief Raise everything which is due now
+ *
+ * @return bool -- An interrupt became pending
+ */
+static bool raise_events(bool stop)
+{
+    bool raised = false;
+
+    if (!stop && tick_enabled && (next_tick_us <= now_us)) {
+        next_tick_us += SIM_US_PER_MS;
+        pending_tick = true;
+        SCB->ICSR |= SCB_ICSR_PENDSTSET_Msk;
+        raised = true;
+    }
+
+    for (uint8_t i = 0; !stop && (i < SIM_DMA_AMOUNT); i++) {
+        if (dma_active[i] && (dma_done_us[i] <= now_us)) {
+            dma_active[i]  = false;
+            pending_dma[i] = true;
+            raised         = true;
+        }
+    }
+
+    while ((rx_head != rx_tail) && (next_rx_us <= now_us)) {
+        uint8_t byte = rx_bytes[rx_tail++ & (RX_BUFFER_SIZE - 1)];
+
+        next_rx_us += sim_uart_byte_time_us();
+        stats.rx_bytes++;
+
+        if (stop || (huart2.RxState != HAL_UART_STATE_BUSY_RX)) {
+            stats.rx_lost++;
+            continue;
+        }
+
+        *huart2.pRxBuffPtr++ = byte;
+
+        if (--huart2.RxXferCount == 0) {
+            huart2.RxState = HAL_UART_STATE_READY;
+            pending_rx     = true;
+            raised         = true;
+        }
+    }
+
+    while ((event_next < event_amount) && (events[event_next].time_us <= now_us)) {
+        const event_t*      event = &events[event_next++];
+        const button_pin_t* pin   = &BUTTON_PINS[event->button];
+
+        switch (event->type) {
+        case EVENT_PRESS:
+        case EVENT_RELEASE:
+            // Buttons are active high, both edges trigger the EXTI line
+            if (event->type == EVENT_PRESS) {
+                pin->port->IDR |= pin->pin;
+            } else {
+                pin->port->IDR &= ~(uint32_t)pin->pin;
+            }
+
+            pending_exti |= pin->pin;
+            raised = true;
+            break;
+
+        case EVENT_REMOTE_PRESS:
+        case EVENT_REMOTE_RELEASE:
+            send_remote_input(event->button, event->type == EVENT_REMOTE_PRESS);
+            break;
+
+        case EVENT_DUMP:
+            sim_dump(stdout);
+            break;
+
+        case EVENT_END:
+            sim_finish("end of script");
+            break;
+        }
+    }
+
+    if (now_us >= end_us) {
+        sim_finish("end of simulated time");
+    }
+
+    return raised;
+}
+
+/**
+ * @brief Advance the virtual time up to target_us
+ *
+ * @param[in] target_us -- Time to run to [us]
+ * @param[in] wake      -- Return as soon as an interrupt becomes pending (WFI)
+ * @param[in] stop      -- Stop mode
+ */
+static void run_until(uint64_t target_us, bool wake, bool stop)
+{
+    for (;;) {
+        uint64_t next = next_event_us(stop);
+
+        if (next > target_us) {
+            set_time(target_us);
+            return;
+        }
+
+        set_time(next);
+
+        bool raised = raise_events(stop);
+
+        if (raised) {
+            dispatch();
+        }
+
+        if (raised && wake) {
+            return;
+        }
+    }
+}
+
+void sim_init(const sim_options_t* options_in)
+{
+    options = *options_in;
+
+    sim_max7219_init();
+    sim_ssd1306_init();
+
+    load_flash(options.flash_path);
+
+    if (options.script_path != NULL) {
+        load_script(options.script_path);
+    }
+
+    if (options.uart_path != NULL) {
+        uart_file = fopen(options.uart_path, "wb");
+
+        if (uart_file == NULL) {
+            fail("cannot create UART output", options.uart_path);
+        }
+    }
+
+    if (options.duration_ms > 0) {
+        end_us = options.duration_ms * SIM_US_PER_MS;
+    } else if (event_amount > 0) {
+        end_us = events[event_amount - 1].time_us + SIM_DEFAULT_TAIL_MS * SIM_US_PER_MS;
+    } else {
+        end_us = SIM_DEFAULT_DURATION_MS * SIM_US_PER_MS;
+    }
+}
+
+uint64_t sim_time_us(void)
+{
+    return now_us;
+}
+
+void sim_busy_wait(uint64_t duration_us)
+{
+    stats.busy_us += duration_us;
+    run_until(now_us + duration_us, false, false);
+}
+
+void sim_wait_for_interrupt(bool stop)
+{
+    uint64_t start = now_us;
+
+    if (pending_tick || (pending_exti != 0) || pending_dma[SIM_DMA_SPI] || pending_dma[SIM_DMA_I2C] ||
+        pending_dma[SIM_DMA_UART] || pending_rx) {
+        dispatch(); // Does not sleep, served unless masked
+        return;
+    }
+
+    run_until(UINT64_MAX, true, stop);
+
+    if (stop) {
+        stats.stop_us += now_us - start;
+        stats.stop_count++;
+    } else {
+        stats.sleep_us += now_us - start;
+    }
+}
+
+void sim_set_primask(uint32_t primask_in)
+{
+    primask = primask_in & 1U;
+
+    dispatch();
+}
+
+uint32_t sim_get_primask(void)
+{
+    return primask;
+}
+
+void sim_set_tick_enabled(bool enabled)
+{
+    if (enabled && !tick_enabled) {
+        next_tick_us = now_us + SIM_US_PER_MS; // Counter restarts from the reload value
+    }
+
+    tick_enabled = enabled;
+}
+
+void sim_dma_start(sim_dma_t dma, uint64_t duration_us)
+{
+    dma_active[dma]  = true;
+    dma_done_us[dma] = now_us + ((duration_us > 0) ? duration_us : 1);
+}
+
+bool sim_dma_busy(sim_dma_t dma)
+{
+    return dma_active[dma] || pending_dma[dma];
+}
+
+void sim_uart_write(const uint8_t* data, uint16_t length)
+{
+    stats.uart_bytes += length;
+
+    if (uart_file != NULL) {
+        fwrite(data, 1, length, uart_file);
+    }
+}
+
+void sim_on_matrix_change(void)
+{
+    if (!options.trace) {
+        return;
+    }
+
+    printf("[%10.3f ms] matrix\n", (double)now_us / SIM_US_PER_MS);
+    sim_max7219_print(stdout);
+}
+
+void sim_on_beep(void)
+{
+    stats.beeps++;
+}
+
+void sim_dump(FILE* stream)
+{
+    fprintf(stream, "[%10.3f ms] matrix\n", (double)now_us / SIM_US_PER_MS);
+    sim_max7219_print(stream);
+    fprintf(stream, "[%10.3f ms] oled\n", (double)now_us / SIM_US_PER_MS);
+    sim_ssd1306_print(stream);
+}
+
+void sim_finish(const char* reason)
+{
+    const sim_max7219_stats_t* spi = sim_max7219_get_stats();
+    const sim_ssd1306_stats_t* i2c = sim_ssd1306_get_stats();
+    double                     run = (now_us > 0) ? (double)now_us : 1.0;
+
+    printf("=== %s ===\n", reason);
+    sim_dump(stdout);
+
+    printf("time:    %.3f ms, %u ticks\n", (double)now_us / SIM_US_PER_MS, stats.ticks);
+    printf("cpu:     sleep %.1f %%, stop %.1f %% (%u entries), bus polling %.1f %%\n", 100.0 * stats.sleep_us / run,
+           100.0 * stats.stop_us / run, stats.stop_count, 100.0 * stats.busy_us / run);
+    printf("matrix:  %u words in %u CS windows, %u image changes, SPI busy %.3f ms\n", spi->words, spi->windows,
+           spi->changes, (double)spi->bus_us / SIM_US_PER_MS);
+    printf("oled:    %u bytes (%u GDDRAM) in %u transfers, I2C busy %.3f ms\n", i2c->bytes, i2c->data, i2c->transfers,
+           (double)i2c->bus_us / SIM_US_PER_MS);
+    printf("buzzer:  %u beeps\n", stats.beeps);
+    printf("uart:    %u bytes sent, %u received (%u lost) at %u baud\n", stats.uart_bytes, stats.rx_bytes,
+           stats.rx_lost, huart2.Init.BaudRate);
+
+    if (options.pbm_path != NULL) {
+        FILE* file = fopen(options.pbm_path, "w");
+
+        if (file != NULL) {
+            sim_ssd1306_write_pbm(file);
+            fclose(file);
+        }
+    }
+
+    save_flash(options.flash_path);
+
+    if (uart_file != NULL) {
+        fclose(uart_file);
+    }
+
+    fflush(stdout);
+    exit(EXIT_SUCCESS);
+}
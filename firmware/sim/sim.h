@@ -0,0 +1,151 @@
+/**
+ * @file sim.h
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ * Host simulator core: virtual clock, interrupt dispatching and scripted button and remote control input.
+ *
+ * The firmware code itself runs in zero virtual time. Time only advances while the CPU waits (WFI, stop mode) or
+ * polls a blocking bus transfer, so a run is deterministic and independent of the host speed.
+ */
+
+#ifndef SIM_H_
+#define SIM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "stm32f0xx_hal.h"
+
+#define SIM_US_PER_MS 1000ULL
+
+/**
+ * @brief Simulated DMA channels
+ */
+typedef enum {
+    SIM_DMA_SPI,  // SPI1 TX (MAX7219)
+    SIM_DMA_I2C,  // I2C1 TX (SSD1306)
+    SIM_DMA_UART, // USART2 TX (telemetry)
+    SIM_DMA_AMOUNT,
+} sim_dma_t;
+
+/**
+ * @brief Simulator statistics
+ */
+typedef struct {
+    uint64_t sleep_us;   // Time spent in WFI
+    uint64_t stop_us;    // Time spent in stop mode
+    uint64_t busy_us;    // Time spent polling blocking bus transfers
+    uint32_t ticks;      // SysTick interrupts
+    uint32_t stop_count; // Stop mode entries
+    uint32_t beeps;      // Buzzer activations
+    uint32_t uart_bytes; // Bytes sent over USART2
+    uint32_t rx_bytes;   // Bytes received over USART2 (remote commands of the script)
+    uint32_t rx_lost;    // Received bytes lost, because no reception was started
+} sim_stats_t;
+
+/**
+ * @brief Simulator options
+ */
+typedef struct {
+    const char* script_path; // Button script (NULL: no input)
+    const char* flash_path;  // Flash image, loaded at start and saved at the end (NULL: erased flash)
+    const char* pbm_path;    // OLED image written at the end (NULL: none)
+    const char* uart_path;   // USART2 TX stream, e.g. for tools/telemetry.py (NULL: discarded)
+    uint64_t    duration_ms; // Simulated time (0: until the script is done + SIM_DEFAULT_TAIL_MS)
+    bool        trace;       // Print the matrix whenever it changes
+} sim_options_t;
+
+#define SIM_DEFAULT_TAIL_MS     2000  // Simulated time after the last script command [ms]
+#define SIM_DEFAULT_DURATION_MS 10000 // Simulated time without script [ms]
+
+/**
+ * @brief Initialize the simulator (loads script and flash image, exits on error)
+ *
+ * @param[in] options -- Options
+ */
+void sim_init(const sim_options_t* options);
+
+/**
+ * @brief Current virtual time
+ *
+ * @return uint64_t -- [us]
+ */
+uint64_t sim_time_us(void);
+
+/**
+ * @brief Let time pass while the CPU is busy (e.g., polling a blocking transfer), interrupts are served meanwhile
+ *
+ * @param[in] duration_us -- [us]
+ */
+void sim_busy_wait(uint64_t duration_us);
+
+/**
+ * @brief Sleep until the next interrupt (stop mode: until the next button edge)
+ *
+ * @param[in] stop -- Stop mode (SysTick and DMA are not running)
+ */
+void sim_wait_for_interrupt(bool stop);
+
+/**
+ * @brief Interrupt mask (PRIMASK)
+ */
+void     sim_set_primask(uint32_t primask);
+uint32_t sim_get_primask(void);
+
+/**
+ * @brief Enable/disable the SysTick interrupt (HAL_SuspendTick()/HAL_ResumeTick())
+ */
+void sim_set_tick_enabled(bool enabled);
+
+/**
+ * @brief Schedule the completion interrupt of a DMA transfer
+ *
+ * @param[in] dma         -- DMA channel
+ * @param[in] duration_us -- Transfer time [us]
+ */
+void sim_dma_start(sim_dma_t dma, uint64_t duration_us);
+
+/**
+ * @brief Check if a DMA transfer is in progress
+ */
+bool sim_dma_busy(sim_dma_t dma);
+
+/**
+ * @brief Bytes sent over USART2
+ *
+ * @param[in] data   -- Data
+ * @param[in] length -- [bytes]
+ */
+void sim_uart_write(const uint8_t* data, uint16_t length);
+
+/**
+ * @brief Time a byte takes on USART2 at the current baud rate
+ *
+ * @return uint64_t -- [us]
+ */
+uint64_t sim_uart_byte_time_us(void);
+
+/**
+ * @brief Notifications of the simulated peripherals
+ */
+void sim_on_matrix_change(void);
+void sim_on_beep(void);
+
+/**
+ * @brief End the simulation (prints the displays and statistics, saves the flash image) and exit the process
+ *
+ * @param[in] reason -- Reason printed to the report
+ */
+void sim_finish(const char* reason);
+
+/**
+ * @brief Print both displays with a timestamp
+ *
+ * @param[in] stream -- Output stream
+ */
+void sim_dump(FILE* stream);
+
+#endif /* SIM_H_ */
@@ -0,0 +1,464 @@
+/**
+ * @file sim_hal.c
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ * Simulated HAL. Bus transfers are decoded by the display models and take the time they would take on the wire:
+ * blocking transfers let the virtual time pass, DMA transfers raise their completion interrupt after that time.
+ */
+
+#include <string.h>
+
+#include "main.h"
+#include "sim.h"
+#include "sim_max7219.h"
+#include "sim_ssd1306.h"
+
+#define SIM_I2C_HZ       400000 // Fast mode, see hi2c1.Init.Timing
+#define SIM_I2C_BITS     9      // Per byte incl. ACK
+#define SIM_SPI_BITS     16     // Per frame (SPI_DATASIZE_16BIT)
+#define SIM_UART_BITS    10     // Per byte incl. start and stop bit (8N1)
+#define SIM_US_PER_S     1000000ULL
+#define SIM_FLASH_ERASED 0xFFFF
+
+volatile uint32_t   uwTick          = 0;
+HAL_TickFreqTypeDef uwTickFreq      = HAL_TICK_FREQ_DEFAULT;
+uint32_t            SystemCoreClock = HSI_VALUE;
+
+SysTick_Type sim_systick = { .LOAD = (HSI_VALUE / 1000) - 1 };
+SCB_Type     sim_scb     = { 0 };
+
+GPIO_TypeDef sim_gpioa = { 0 };
+GPIO_TypeDef sim_gpiob = { 0 };
+GPIO_TypeDef sim_gpiof = { 0 };
+
+static TIM_TypeDef tim2           = { 0 };
+static uint64_t    tim2_time_us   = 0; // Virtual time the counter has been brought up to
+static uint64_t    tim2_remainder = 0; // PCLK cycles below one counter tick
+
+uint8_t sim_flash[SIM_FLASH_SIZE];
+
+// Handles of the CubeMX code (main.c)
+SPI_HandleTypeDef  hspi1  = { .Init = { .BaudRatePrescaler = SPI_BAUDRATEPRESCALER_2 } };
+I2C_HandleTypeDef  hi2c1  = { .Init = { .Timing = 0x0010020A } };
+UART_HandleTypeDef huart2 = { .Init = { .BaudRate = 115200 }, .RxState = HAL_UART_STATE_READY };
+
+static uint64_t transfer_time_us(uint32_t bits, uint32_t bitrate)
+{
+    return ((uint64_t)bits * SIM_US_PER_S + bitrate - 1) / bitrate;
+}
+
+static uint32_t spi_bitrate(const SPI_HandleTypeDef* hspi)
+{
+    return HAL_RCC_GetPCLK1Freq() / (2U << (hspi->Init.BaudRatePrescaler / SPI_CR1_BR_0));
+}
+
+/**
+ * @brief Target flash addresses are 32 bit, restore the upper bits of the host address
+ */
+static uint8_t* flash_address(uint32_t address, uint32_t size)
+{
+    uintptr_t host = (uintptr_t)((((uint64_t)(uintptr_t)sim_flash) & ~(uint64_t)0xFFFFFFFFU) | address);
+
+    if ((host < (uintptr_t)sim_flash) || ((host + size) > ((uintptr_t)sim_flash + SIM_FLASH_SIZE))) {
+        return NULL;
+    }
+
+    return (uint8_t*)host;
+}
+
+static void set_system_clock(uint32_t frequency)
+{
+    sim_tim2(); // Counted at the old PCLK up to now
+
+    SystemCoreClock = frequency;
+    SysTick->LOAD   = (frequency / 1000) - 1; // HAL_InitTick()
+}
+
+void SystemClock_Config(void)
+{
+    set_system_clock(HSI_VALUE);
+}
+
+void Error_Handler(void)
+{
+    sim_finish("Error_Handler()");
+}
+
+/*
+ * Tick and core
+ */
+uint32_t HAL_GetTick(void)
+{
+    return uwTick;
+}
+
+void HAL_IncTick(void)
+{
+    uwTick += uwTickFreq;
+}
+
+void HAL_SuspendTick(void)
+{
+    sim_set_tick_enabled(false);
+}
+
+void HAL_ResumeTick(void)
+{
+    sim_set_tick_enabled(true);
+}
+
+void __WFI(void)
+{
+    sim_wait_for_interrupt(false);
+}
+
+void __disable_irq(void)
+{
+    sim_set_primask(1);
+}
+
+void __enable_irq(void)
+{
+    sim_set_primask(0);
+}
+
+uint32_t __get_PRIMASK(void)
+{
+    return sim_get_primask();
+}
+
+void __set_PRIMASK(uint32_t priMask)
+{
+    sim_set_primask(priMask);
+}
+
+/*
+ * GPIO
+ */
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin)
+{
+    return (GPIOx->IDR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    bool was_set = (GPIOx->ODR & GPIO_Pin) != 0;
+
+    if (PinState == GPIO_PIN_SET) {
+        GPIOx->ODR |= GPIO_Pin;
+    } else {
+        GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+    }
+
+    if ((GPIOx == MAX_SPI_CS_GPIO_Port) && (GPIO_Pin == MAX_SPI_CS_Pin)) {
+        if (sim_max7219_cs(PinState == GPIO_PIN_SET)) {
+            sim_on_matrix_change();
+        }
+    }
+
+    if ((GPIOx == BUZZER_GPIO_Port) && (GPIO_Pin == BUZZER_Pin) && !was_set && (PinState == GPIO_PIN_SET)) {
+        sim_on_beep();
+    }
+}
+
+/*
+ * RCC and PWR
+ */
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef* RCC_OscInitStruct)
+{
+    (void)RCC_OscInitStruct;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef* RCC_ClkInitStruct, uint32_t FLatency)
+{
+    (void)FLatency;
+
+    set_system_clock((RCC_ClkInitStruct->SYSCLKSource == RCC_SYSCLKSOURCE_HSI48) ? HSI48_VALUE : HSI_VALUE);
+
+    return HAL_OK;
+}
+
+uint32_t HAL_RCC_GetPCLK1Freq(void)
+{
+    return SystemCoreClock; // APB prescaler 1
+}
+
+void HAL_PWR_EnterSTOPMode(uint32_t Regulator, uint8_t STOPEntry)
+{
+    (void)Regulator;
+    (void)STOPEntry;
+
+    sim_tim2();
+    sim_wait_for_interrupt(true);
+
+    SystemCoreClock = HSI_VALUE; // Woken up on HSI, SysTick keeps its reload value until reconfigured
+    tim2_time_us    = sim_time_us(); // Not clocked in stop mode
+}
+
+/*
+ * TIM2
+ */
+TIM_TypeDef* sim_tim2(void)
+{
+    uint64_t now_us = sim_time_us();
+
+    if (tim2.CR1 & TIM_CR1_CEN) {
+        uint64_t cycles = (now_us - tim2_time_us) * HAL_RCC_GetPCLK1Freq() / SIM_US_PER_S + tim2_remainder;
+
+        tim2.CNT += (uint32_t)(cycles / (tim2.PSC + 1)); // ARR is UINT32_MAX
+        tim2_remainder = cycles % (tim2.PSC + 1);
+    }
+
+    tim2_time_us = now_us;
+
+    return &tim2;
+}
+
+/*
+ * SPI (MAX7219)
+ */
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef* hspi)
+{
+    (void)hspi;
+
+    return HAL_OK;
+}
+
+static void spi_shift(const uint8_t* pData, uint16_t Size)
+{
+    for (uint16_t i = 0; i < Size; i++) {
+        uint16_t word;
+
+        memcpy(&word, &pData[2 * i], sizeof(word)); // 16-bit frames
+        sim_max7219_word(word);
+    }
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)Timeout;
+
+    if (sim_dma_busy(SIM_DMA_SPI)) {
+        return HAL_BUSY;
+    }
+
+    uint64_t duration = transfer_time_us((uint32_t)Size * SIM_SPI_BITS, spi_bitrate(hspi));
+
+    spi_shift(pData, Size);
+    sim_max7219_add_bus_time(duration);
+    sim_busy_wait(duration);
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size)
+{
+    if (sim_dma_busy(SIM_DMA_SPI)) {
+        return HAL_BUSY;
+    }
+
+    uint64_t duration = transfer_time_us((uint32_t)Size * SIM_SPI_BITS, spi_bitrate(hspi));
+
+    spi_shift(pData, Size);
+    sim_max7219_add_bus_time(duration);
+    sim_dma_start(SIM_DMA_SPI, duration);
+
+    return HAL_OK;
+}
+
+/*
+ * I2C (SSD1306)
+ */
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint32_t Trials, uint32_t Timeout)
+{
+    (void)hi2c;
+    (void)Trials;
+    (void)Timeout;
+
+    return (DevAddress == SIM_SSD1306_I2C_ADDR) ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint8_t* pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)hi2c;
+    (void)Timeout;
+
+    if (sim_dma_busy(SIM_DMA_I2C)) {
+        return HAL_BUSY;
+    }
+
+    if ((DevAddress != SIM_SSD1306_I2C_ADDR) || (Size == 0)) {
+        return HAL_ERROR; // NACK
+    }
+
+    uint64_t duration = transfer_time_us((1U + Size) * SIM_I2C_BITS, SIM_I2C_HZ);
+
+    sim_ssd1306_write(pData[0], &pData[1], Size - 1); // First byte is the control byte
+    sim_ssd1306_add_bus_time(duration);
+    sim_busy_wait(duration);
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t* pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)hi2c;
+    (void)MemAddSize;
+    (void)Timeout;
+
+    if (sim_dma_busy(SIM_DMA_I2C)) {
+        return HAL_BUSY;
+    }
+
+    if (DevAddress != SIM_SSD1306_I2C_ADDR) {
+        return HAL_ERROR; // NACK
+    }
+
+    uint64_t duration = transfer_time_us((2U + Size) * SIM_I2C_BITS, SIM_I2C_HZ);
+
+    sim_ssd1306_write((uint8_t)MemAddress, pData, Size); // "Memory address" is the control byte
+    sim_ssd1306_add_bus_time(duration);
+    sim_busy_wait(duration);
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write_DMA(I2C_HandleTypeDef* hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t* pData, uint16_t Size)
+{
+    (void)hi2c;
+    (void)MemAddSize;
+
+    if (sim_dma_busy(SIM_DMA_I2C)) {
+        return HAL_BUSY;
+    }
+
+    if (DevAddress != SIM_SSD1306_I2C_ADDR) {
+        return HAL_ERROR; // NACK
+    }
+
+    uint64_t duration = transfer_time_us((2U + Size) * SIM_I2C_BITS, SIM_I2C_HZ);
+
+    sim_ssd1306_write((uint8_t)MemAddress, pData, Size);
+    sim_ssd1306_add_bus_time(duration);
+    sim_dma_start(SIM_DMA_I2C, duration);
+
+    return HAL_OK;
+}
+
+/*
+ * UART
+ */
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef* huart)
+{
+    if (sim_dma_busy(SIM_DMA_UART)) {
+        sim_finish("USART2 reconfigured during a DMA transfer");
+    }
+
+    huart->RxState   = HAL_UART_STATE_READY; // A running reception is lost
+    huart->ErrorCode = HAL_UART_ERROR_NONE;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef* huart, const uint8_t* pData, uint16_t Size)
+{
+    if (sim_dma_busy(SIM_DMA_UART)) {
+        return HAL_BUSY;
+    }
+
+    sim_uart_write(pData, Size);
+    sim_dma_start(SIM_DMA_UART, transfer_time_us((uint32_t)Size * SIM_UART_BITS, huart->Init.BaudRate));
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size)
+{
+    if (huart->RxState != HAL_UART_STATE_READY) {
+        return HAL_BUSY;
+    }
+
+    if ((pData == NULL) || (Size == 0)) {
+        return HAL_ERROR;
+    }
+
+    huart->pRxBuffPtr  = pData;
+    huart->RxXferCount = Size;
+    huart->RxState     = HAL_UART_STATE_BUSY_RX;
+    huart->ErrorCode   = HAL_UART_ERROR_NONE;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef* huart)
+{
+    huart->RxState   = HAL_UART_STATE_READY;
+    huart->ErrorCode = HAL_UART_ERROR_NONE;
+
+    return HAL_OK;
+}
+
+uint32_t HAL_UART_GetError(const UART_HandleTypeDef* huart)
+{
+    return huart->ErrorCode;
+}
+
+uint64_t sim_uart_byte_time_us(void)
+{
+    return transfer_time_us(SIM_UART_BITS, huart2.Init.BaudRate);
+}
+
+
+/*
+ * FLASH
+ */
+HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data)
+{
+    uint8_t* cell = flash_address(Address, sizeof(uint16_t));
+    uint16_t current;
+    uint16_t value = (uint16_t)Data;
+
+    if ((TypeProgram != FLASH_TYPEPROGRAM_HALFWORD) || (cell == NULL)) {
+        return HAL_ERROR;
+    }
+
+    memcpy(&current, cell, sizeof(current));
+
+    if (current != SIM_FLASH_ERASED) {
+        return HAL_ERROR; // PGERR, the halfword is not erased
+    }
+
+    memcpy(cell, &value, sizeof(value));
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef* pEraseInit, uint32_t* PageError)
+{
+    uint8_t* page = flash_address(pEraseInit->PageAddress, pEraseInit->NbPages * SIM_FLASH_PAGE_SIZE);
+
+    *PageError = 0xFFFFFFFFU;
+
+    if (page == NULL) {
+        *PageError = pEraseInit->PageAddress;
+        return HAL_ERROR;
+    }
+
+    memset(page, 0xFF, pEraseInit->NbPages * SIM_FLASH_PAGE_SIZE);
+
+    return HAL_OK;
+}
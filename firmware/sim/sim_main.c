@@ -0,0 +1,84 @@
+/**
+ * @file sim_main.c
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ * Host entry point, replaces main.c of the target: sets up the simulated hardware and runs app().
+ */
+
+#include <getopt.h>
+#include <stdlib.h>
+
+#include "app.h"
+#include "main.h"
+#include "sim.h"
+
+static void usage(const char* program)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  -s, --script FILE    button script (see sim.c for the format)\n"
+            "  -d, --duration MS    simulated time (default: end of script + %d ms)\n"
+            "  -f, --flash FILE     flash image, loaded at start and saved at the end\n"
+            "  -p, --pbm FILE       write the final OLED image as PBM\n"
+            "  -u, --uart FILE      write the USART2 output (telemetry) to FILE\n"
+            "  -t, --trace          print the matrix whenever it changes\n",
+            program, SIM_DEFAULT_TAIL_MS);
+}
+
+int main(int argc, char* argv[])
+{
+    static const struct option LONG_OPTIONS[] = {
+        { "script", required_argument, NULL, 's' },
+        { "duration", required_argument, NULL, 'd' },
+        { "flash", required_argument, NULL, 'f' },
+        { "pbm", required_argument, NULL, 'p' },
+        { "uart", required_argument, NULL, 'u' },
+        { "trace", no_argument, NULL, 't' },
+        { "help", no_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 },
+    };
+
+    sim_options_t options = { 0 };
+    int           option;
+
+    while ((option = getopt_long(argc, argv, "s:d:f:p:u:th", LONG_OPTIONS, NULL)) != -1) {
+        switch (option) {
+        case 's':
+            options.script_path = optarg;
+            break;
+        case 'd':
+            options.duration_ms = strtoull(optarg, NULL, 10);
+            break;
+        case 'f':
+            options.flash_path = optarg;
+            break;
+        case 'p':
+            options.pbm_path = optarg;
+            break;
+        case 'u':
+            options.uart_path = optarg;
+            break;
+        case 't':
+            options.trace = true;
+            break;
+        case 'h':
+            usage(argv[0]);
+            return EXIT_SUCCESS;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    sim_init(&options);
+
+    // HAL_Init(), SystemClock_Config() and MX_GPIO_Init() of the target
+    SystemClock_Config();
+    HAL_GPIO_WritePin(MAX_SPI_CS_GPIO_Port, MAX_SPI_CS_Pin, GPIO_PIN_SET);
+
+    app(); // Never returns, the simulator ends the process
+
+    return EXIT_SUCCESS;
+}
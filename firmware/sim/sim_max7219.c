@@ -0,0 +1,180 @@
+/**
+ * @file sim_max7219.c
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ * The devices are modelled as a chain of 16-bit shift registers (device 0 is next to the MCU). Only the no-decode
+ * mode is rendered, which is the only mode the firmware uses.
+ */
+
+#include "sim_max7219.h"
+
+#include <string.h>
+
+#include "max7219.h"
+
+typedef struct {
+    uint16_t shift;                        // Shift register
+    uint8_t  digits[MAX7219_DIGIT_AMOUNT]; // Digit registers
+    uint8_t  scan_limit;
+    bool     shutdown;
+    bool     display_test;
+} device_t;
+
+/* clang-format off */
+
+// Segment bit of every row of a device (same wiring as the firmware assumes)
+static const uint8_t ROW_SEGMENTS[MAX7219_SEGMENT_AMOUNT] = {
+    MAX7219_SEGMENT_A, MAX7219_SEGMENT_B, MAX7219_SEGMENT_C, MAX7219_SEGMENT_D,
+    MAX7219_SEGMENT_E, MAX7219_SEGMENT_F, MAX7219_SEGMENT_G, MAX7219_SEGMENT_DP,
+};
+
+/* clang-format on */
+
+static device_t            devices[MAX7219_DEVICE_AMOUNT];
+static bool                cs_level = true;
+static sim_max7219_stats_t stats    = { 0 };
+
+static void execute(device_t* device)
+{
+    uint8_t address = (uint8_t)(device->shift >> 8) & 0x0F;
+    uint8_t data    = (uint8_t)device->shift;
+
+    if ((address >= MAX7219_ADR_DIGIT_0) && (address <= MAX7219_ADR_DIGIT_7)) {
+        device->digits[address - MAX7219_ADR_DIGIT_0] = data;
+        return;
+    }
+
+    switch (address) {
+    case MAX7219_ADR_SCAN_LIMIT:
+        device->scan_limit = data & 0x07;
+        break;
+
+    case MAX7219_ADR_SHUTDOWN:
+        device->shutdown = (data & 0x01) == 0;
+        break;
+
+    case MAX7219_ADR_DISPLAY_TEST:
+        device->display_test = (data & 0x01) != 0;
+        break;
+
+    default:
+        break; // No-op, decode mode and intensity do not change the image
+    }
+}
+
+/**
+ * @brief Device of a pixel, see MAX7219_DEVICES_X/Y (chained row by row, device 0 is the top left one)
+ */
+static const device_t* pixel_device(uint8_t col, uint8_t row)
+{
+    return &devices[(row / MAX7219_SEGMENT_AMOUNT) * MAX7219_DEVICES_X + (col / MAX7219_DIGIT_AMOUNT)];
+}
+
+static uint32_t image_hash(void)
+{
+    uint32_t hash = 2166136261U; // FNV-1a
+
+    for (uint8_t row = 0; row < MAX7219_ROW_AMOUNT; row++) {
+        for (uint8_t col = 0; col < MAX7219_COLUMN_AMOUNT; col++) {
+            hash = (hash ^ (sim_max7219_pixel(col, row) ? 1U : 0U)) * 16777619U;
+        }
+    }
+
+    return hash;
+}
+
+void sim_max7219_init(void)
+{
+    memset(devices, 0, sizeof(devices));
+
+    for (uint8_t i = 0; i < MAX7219_DEVICE_AMOUNT; i++) {
+        devices[i].shutdown = true;
+    }
+
+    cs_level = true;
+}
+
+void sim_max7219_word(uint16_t word)
+{
+    stats.words++;
+
+    if (cs_level) {
+        return; // Not selected
+    }
+
+    for (uint8_t i = MAX7219_DEVICE_AMOUNT - 1; i > 0; i--) {
+        devices[i].shift = devices[i - 1].shift;
+    }
+
+    devices[0].shift = word;
+}
+
+bool sim_max7219_cs(bool level)
+{
+    bool rising = !cs_level && level;
+
+    cs_level = level;
+
+    if (!rising) {
+        return false;
+    }
+
+    uint32_t before = image_hash();
+
+    stats.windows++;
+
+    for (uint8_t i = 0; i < MAX7219_DEVICE_AMOUNT; i++) {
+        execute(&devices[i]);
+    }
+
+    if (image_hash() == before) {
+        return false;
+    }
+
+    stats.changes++;
+
+    return true;
+}
+
+void sim_max7219_add_bus_time(uint64_t duration_us)
+{
+    stats.bus_us += duration_us;
+}
+
+bool sim_max7219_pixel(uint8_t col, uint8_t row)
+{
+    const device_t* device = pixel_device(col, row);
+    uint8_t         digit  = col % MAX7219_DIGIT_AMOUNT;
+
+    if (device->shutdown) {
+        return false;
+    }
+
+    if (device->display_test) {
+        return true;
+    }
+
+    if (digit > device->scan_limit) {
+        return false;
+    }
+
+    return (device->digits[digit] & ROW_SEGMENTS[row % MAX7219_SEGMENT_AMOUNT]) != 0;
+}
+
+void sim_max7219_print(FILE* stream)
+{
+    for (uint8_t row = 0; row < MAX7219_ROW_AMOUNT; row++) {
+        for (uint8_t col = 0; col < MAX7219_COLUMN_AMOUNT; col++) {
+            fputc(sim_max7219_pixel(col, row) ? '#' : '.', stream);
+        }
+
+        fputc('\n', stream);
+    }
+}
+
+const sim_max7219_stats_t* sim_max7219_get_stats(void)
+{
+    return &stats;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file sim_max7219.h
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ * Simulated MAX7219 cascade, rebuilds the matrix image from the SPI words and the CS line.
+ */
+
+#ifndef SIM_MAX7219_H_
+#define SIM_MAX7219_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @brief SPI traffic statistics
+ */
+typedef struct {
+    uint32_t words;   // 16-bit words shifted in
+    uint32_t windows; // CS windows (latches)
+    uint32_t changes; // Latches which changed the visible image
+    uint64_t bus_us;  // Time the SPI bus was busy [us]
+} sim_max7219_stats_t;
+
+/**
+ * @brief Reset the devices to their power-up state (shutdown, display cleared)
+ */
+void sim_max7219_init(void);
+
+/**
+ * @brief Shift a 16-bit word into the cascade
+ *
+ * @param[in] word -- Address (high byte) and data (low byte)
+ */
+void sim_max7219_word(uint16_t word);
+
+/**
+ * @brief CS line level, the rising edge latches the shift registers of all devices
+ *
+ * @param[in] level -- CS level
+ *
+ * @return bool -- The visible image changed
+ */
+bool sim_max7219_cs(bool level);
+
+/**
+ * @brief Add bus time to the statistics
+ *
+ * @param[in] duration_us -- [us]
+ */
+void sim_max7219_add_bus_time(uint64_t duration_us);
+
+/**
+ * @brief Check if a pixel of the virtual canvas is lit
+ *
+ * @param[in] col -- Column (0: left)
+ * @param[in] row -- Row (0: top)
+ *
+ * @return bool -- Pixel is lit
+ */
+bool sim_max7219_pixel(uint8_t col, uint8_t row);
+
+/**
+ * @brief Print the matrix image ('#': lit, '.': dark)
+ *
+ * @param[in] stream -- Output stream
+ */
+void sim_max7219_print(FILE* stream);
+
+/**
+ * @brief Get the statistics
+ *
+ * @return const sim_max7219_stats_t* -- Statistics
+ */
+const sim_max7219_stats_t* sim_max7219_get_stats(void);
+
+#endif /* SIM_MAX7219_H_ */
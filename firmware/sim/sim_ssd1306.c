@@ -0,0 +1,249 @@
+/**
+ * @file sim_ssd1306.c
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ * The segment remap (0xA1) and COM scan direction (0xC8) set by the firmware only compensate the mounting of the
+ * module, so the GDDRAM is rendered as is: column = x, bit (y % 8) of page (y / 8) = y. Scrolling is not simulated.
+ */
+
+#include "sim_ssd1306.h"
+
+#include <string.h>
+
+#define PAGE_AMOUNT (SIM_SSD1306_HEIGHT / 8)
+
+typedef enum {
+    ADDRESSING_HORIZONTAL = 0,
+    ADDRESSING_VERTICAL   = 1,
+    ADDRESSING_PAGE       = 2,
+} addressing_t;
+
+typedef struct {
+    uint8_t      ram[PAGE_AMOUNT][SIM_SSD1306_WIDTH];
+    addressing_t addressing;
+    uint8_t      col_start;
+    uint8_t      col_end;
+    uint8_t      page_start;
+    uint8_t      page_end;
+    uint8_t      col;
+    uint8_t      page;
+    bool         display_on;
+    bool         inverted;
+    bool         entire_on;
+    uint8_t      command[8]; // Command being received (command byte + arguments)
+    uint8_t      received;   // Bytes of the command received so far
+} controller_t;
+
+static controller_t        oled;
+static sim_ssd1306_stats_t stats = { 0 };
+
+/**
+ * @brief Total length of a command incl. its arguments
+ */
+static uint8_t command_length(uint8_t command)
+{
+    switch (command) {
+    case 0x20: // Memory addressing mode
+    case 0x81: // Contrast
+    case 0x8D: // Charge pump
+    case 0xA8: // Multiplex ratio
+    case 0xD3: // Display offset
+    case 0xD5: // Clock divide ratio
+    case 0xD9: // Pre-charge period
+    case 0xDA: // COM pins
+    case 0xDB: // VCOMH level
+        return 2;
+
+    case 0x21: // Column address
+    case 0x22: // Page address
+    case 0xA3: // Vertical scroll area
+        return 3;
+
+    case 0x29: // Vertical and horizontal scroll
+    case 0x2A:
+        return 6;
+
+    case 0x26: // Horizontal scroll
+    case 0x27:
+        return 7;
+
+    default:
+        return 1;
+    }
+}
+
+static void execute(const uint8_t* command)
+{
+    uint8_t code = command[0];
+
+    if (code <= 0x0F) {
+        oled.col = (oled.col & 0xF0) | code; // Lower column nibble (page addressing mode)
+        return;
+    }
+
+    if (code <= 0x1F) {
+        oled.col = (uint8_t)(((code & 0x0F) << 4) | (oled.col & 0x0F)) % SIM_SSD1306_WIDTH;
+        return;
+    }
+
+    if ((code >= 0xB0) && (code <= 0xB7)) {
+        oled.page = code & 0x07; // Page start (page addressing mode)
+        return;
+    }
+
+    switch (code) {
+    case 0x20:
+        oled.addressing = (addressing_t)(command[1] & 0x03);
+        break;
+
+    case 0x21:
+        oled.col_start = command[1] % SIM_SSD1306_WIDTH;
+        oled.col_end   = command[2] % SIM_SSD1306_WIDTH;
+        oled.col       = oled.col_start;
+        break;
+
+    case 0x22:
+        oled.page_start = command[1] % PAGE_AMOUNT;
+        oled.page_end   = command[2] % PAGE_AMOUNT;
+        oled.page       = oled.page_start;
+        break;
+
+    case 0xA4:
+    case 0xA5:
+        oled.entire_on = (code == 0xA5);
+        break;
+
+    case 0xA6:
+    case 0xA7:
+        oled.inverted = (code == 0xA7);
+        break;
+
+    case 0xAE:
+    case 0xAF:
+        oled.display_on = (code == 0xAF);
+        break;
+
+    default:
+        break; // No influence on the image
+    }
+}
+
+static void command_byte(uint8_t byte)
+{
+    oled.command[oled.received++] = byte;
+
+    if (oled.received < command_length(oled.command[0])) {
+        return; // Arguments follow
+    }
+
+    execute(oled.command);
+    oled.received = 0;
+}
+
+static void data_byte(uint8_t byte)
+{
+    oled.ram[oled.page][oled.col] = byte;
+    stats.data++;
+
+    switch (oled.addressing) {
+    case ADDRESSING_HORIZONTAL:
+        if (oled.col < oled.col_end) {
+            oled.col++;
+            break;
+        }
+
+        oled.col  = oled.col_start;
+        oled.page = (oled.page < oled.page_end) ? (oled.page + 1) : oled.page_start;
+        break;
+
+    case ADDRESSING_VERTICAL:
+        if (oled.page < oled.page_end) {
+            oled.page++;
+            break;
+        }
+
+        oled.page = oled.page_start;
+        oled.col  = (oled.col < oled.col_end) ? (oled.col + 1) : oled.col_start;
+        break;
+
+    default:
+        oled.col = (oled.col + 1) % SIM_SSD1306_WIDTH; // Page addressing mode, stays in the page
+        break;
+    }
+}
+
+void sim_ssd1306_init(void)
+{
+    memset(&oled, 0, sizeof(oled));
+
+    oled.addressing = ADDRESSING_PAGE;
+    oled.col_end    = SIM_SSD1306_WIDTH - 1;
+    oled.page_end   = PAGE_AMOUNT - 1;
+}
+
+void sim_ssd1306_write(uint8_t control, const uint8_t* data, uint16_t length)
+{
+    stats.transfers++;
+    stats.bytes += 2 + length; // Address + control byte
+
+    for (uint16_t i = 0; i < length; i++) {
+        if (control == SIM_SSD1306_CONTROL_DATA) {
+            data_byte(data[i]);
+        } else {
+            command_byte(data[i]);
+        }
+    }
+}
+
+void sim_ssd1306_add_bus_time(uint64_t duration_us)
+{
+    stats.bus_us += duration_us;
+}
+
+bool sim_ssd1306_pixel(uint8_t x, uint8_t y)
+{
+    if (!oled.display_on) {
+        return false;
+    }
+
+    if (oled.entire_on) {
+        return true;
+    }
+
+    bool lit = (oled.ram[y / 8][x] & (1U << (y % 8))) != 0;
+
+    return lit != oled.inverted;
+}
+
+void sim_ssd1306_print(FILE* stream)
+{
+    static const char* const BLOCKS[4] = { " ", "▀", "▄", "█" }; // none, upper, lower, both
+
+    for (uint8_t y = 0; y < SIM_SSD1306_HEIGHT; y += 2) {
+        for (uint8_t x = 0; x < SIM_SSD1306_WIDTH; x++) {
+            fputs(BLOCKS[(sim_ssd1306_pixel(x, y) ? 1 : 0) | (sim_ssd1306_pixel(x, y + 1) ? 2 : 0)], stream);
+        }
+
+        fputc('\n', stream);
+    }
+}
+
+void sim_ssd1306_write_pbm(FILE* stream)
+{
+    fprintf(stream, "P1\n%d %d\n", SIM_SSD1306_WIDTH, SIM_SSD1306_HEIGHT);
+
+    for (uint8_t y = 0; y < SIM_SSD1306_HEIGHT; y++) {
+        for (uint8_t x = 0; x < SIM_SSD1306_WIDTH; x++) {
+            fputc(sim_ssd1306_pixel(x, y) ? '1' : '0', stream);
+        }
+
+        fputc('\n', stream);
+    }
+}
+
+const sim_ssd1306_stats_t* sim_ssd1306_get_stats(void)
+{
+    return &stats;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file sim_ssd1306.h
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ * Simulated SSD1306 OLED controller, rebuilds the 128x64 image from the I2C command and data streams.
+ */
+
+#ifndef SIM_SSD1306_H_
+#define SIM_SSD1306_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define SIM_SSD1306_WIDTH  128
+#define SIM_SSD1306_HEIGHT 64
+
+#define SIM_SSD1306_I2C_ADDR        0x78 // 8-bit address as used by the HAL
+#define SIM_SSD1306_CONTROL_COMMAND 0x00 // Control byte of a command stream
+#define SIM_SSD1306_CONTROL_DATA    0x40 // Control byte of a data stream
+
+/**
+ * @brief I2C traffic statistics
+ */
+typedef struct {
+    uint32_t transfers; // I2C transfers to the OLED
+    uint32_t bytes;     // Bytes incl. address and control byte
+    uint32_t data;      // GDDRAM bytes written
+    uint64_t bus_us;    // Time the I2C bus was busy [us]
+} sim_ssd1306_stats_t;
+
+/**
+ * @brief Reset the controller to its power-up state (display off, page addressing mode)
+ */
+void sim_ssd1306_init(void);
+
+/**
+ * @brief One I2C write transfer to the controller
+ *
+ * @param[in] control -- Control byte (SIM_SSD1306_CONTROL_COMMAND or SIM_SSD1306_CONTROL_DATA)
+ * @param[in] data    -- Commands or GDDRAM data
+ * @param[in] length  -- Amount of bytes
+ */
+void sim_ssd1306_write(uint8_t control, const uint8_t* data, uint16_t length);
+
+/**
+ * @brief Add bus time to the statistics
+ *
+ * @param[in] duration_us -- [us]
+ */
+void sim_ssd1306_add_bus_time(uint64_t duration_us);
+
+/**
+ * @brief Check if a pixel is lit
+ *
+ * @param[in] x -- Column (0: left)
+ * @param[in] y -- Row (0: top)
+ *
+ * @return bool -- Pixel is lit
+ */
+bool sim_ssd1306_pixel(uint8_t x, uint8_t y);
+
+/**
+ * @brief Print the image, two rows per line (UTF-8 half blocks)
+ *
+ * @param[in] stream -- Output stream
+ */
+void sim_ssd1306_print(FILE* stream);
+
+/**
+ * @brief Write the image as plain PBM (P1)
+ *
+ * @param[in] stream -- Output stream
+ */
+void sim_ssd1306_write_pbm(FILE* stream);
+
+/**
+ * @brief Get the statistics
+ *
+ * @return const sim_ssd1306_stats_t* -- Statistics
+ */
+const sim_ssd1306_stats_t* sim_ssd1306_get_stats(void);
+
+#endif /* SIM_SSD1306_H_ */
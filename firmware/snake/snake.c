@@ -8,19 +8,26 @@
 
 #include "snake.h"
 
-#include <stdio.h>
-
 #include "app.h"
+#include "fmt.h"
 #include "max7219.h"
+#include "profile.h"
 #include "ssd1306.h"
+#include "storage.h"
+#include "telemetry.h"
 
 #define NO_FOOD 0xFF
 
-#define MAX_SNAKE_LENGTH 63
+#define SNAKE_CELL_AMOUNT (MAX7219_COLUMN_AMOUNT * MAX7219_ROW_AMOUNT)
+#define MAX_SNAKE_LENGTH  (SNAKE_CELL_AMOUNT - 1)
+
+#define SNAKE_OCCUPANCY_WORDS ((SNAKE_CELL_AMOUNT + 31) / 32)
 
-#define FLASH_HIGHSCORE_ADDRESS 0x08007F00 // Last page
+#define SNAKE_CELL(col, row) ((snake_cell_t)((row) * MAX7219_COLUMN_AMOUNT + (col)))
+#define SNAKE_CELL_COL(cell) ((uint8_t)((cell) % MAX7219_COLUMN_AMOUNT))
+#define SNAKE_CELL_ROW(cell) ((uint8_t)((cell) / MAX7219_COLUMN_AMOUNT))
 
-#define SNAKE_SEQUENCE_PERIOD_10MS 25 // Period for each sequence (i.e., snake "steps") in multiple of 10ms
+#define SNAKE_SEQUENCE_PERIOD_MS 250 // Period for each sequence (i.e., snake "steps") [ms]
 
 typedef enum {
     MOVE_NORMAL,    // A regular move (game not over; snake did not eat food)
@@ -33,105 +40,168 @@ typedef struct {
     uint8_t row;
 } coordinates_t;
 
-typedef struct snake_part {
-    uint8_t            col;
-    uint8_t            row;
-    struct snake_part* next;
-} snake_part_t;
-
-static snake_part_t* head                                                    = NULL;
-static snake_part_t  snake_fields[MAX7219_COLUMN_AMOUNT][MAX7219_ROW_AMOUNT] = { 0 };
-
-static snake_part_t food = { NO_FOOD, NO_FOOD };
-
-static void     add_head(snake_part_t** snake_head, coordinates_t new_head);
-static void     add_head_remove_tail(snake_part_t** snake_head, coordinates_t new_head);
-static bool     is_game_over(coordinates_t new_head);
-static bool     is_eating(coordinates_t new_head);
-static move_t   apply_new_head(snake_part_t** snake_head, coordinates_t new_head);
-static move_t   move_left(snake_part_t** snake_head);
-static move_t   move_right(snake_part_t** snake_head);
-static move_t   move_up(snake_part_t** snake_head);
-static move_t   move_down(snake_part_t** snake_head);
-static uint8_t  calc_score(void);
-static void     print_score(uint16_t score);
-static void     flash_init_highscore(void);
-static uint16_t flash_load_highscore(void);
-static void     flash_save_highscore(uint16_t score);
-static void     convert_to_matrix(bool matrix[MAX7219_COLUMN_AMOUNT][MAX7219_ROW_AMOUNT]);
-static void     init(void);
-static void     lcd_start(void);
-static void     food_generate(void);
-static void     handle_score(void);
-static move_t   move_snake(button_t direction);
-static void     start_game(button_t* direction);
-
-void snake(void)
-{
-    button_t button     = BUTTON_NONE;
-    button_t direction  = BUTTON_RIGHT;
-    move_t   move_state = MOVE_NORMAL;
+// Packed coordinates (row * MAX7219_COLUMN_AMOUNT + col)
+#if SNAKE_CELL_AMOUNT <= 256
+typedef uint8_t snake_cell_t;
+#else
+typedef uint16_t snake_cell_t;
+#endif
+
+/**
+ * @brief Snake body as ring buffer, cells[head] is the head, the tail is (length - 1) cells behind it
+ *
+ * The occupancy bitboard has one bit per cell (bit = cell % 32 of word cell / 32) which is set while the cell belongs
+ * to the snake.
+ */
+typedef struct {
+    snake_cell_t cells[MAX_SNAKE_LENGTH];
+    uint16_t     head;
+    uint16_t     length;
+    uint32_t     occupancy[SNAKE_OCCUPANCY_WORDS];
+} snake_body_t;
 
-    srand(HAL_GetTick());
+typedef enum {
+    PHASE_START,     // Waiting for the user to start
+    PHASE_RUNNING,   // Snake is moving
+    PHASE_GAME_OVER, // Waiting for the user to leave
+} phase_t;
 
-    flash_init_highscore();
+typedef struct {
+    snake_body_t  body;
+    coordinates_t food;
+    button_t      direction;
+    phase_t       phase;
+    uint32_t      step_elapsed_ms; // Time since the last step [ms]
+} snake_state_t;
+
+GAME_STATE_ASSERT(snake_state_t);
+
+static uint8_t       popcount(uint32_t word);
+static bool          is_occupied(const snake_body_t* body, snake_cell_t cell);
+static void          set_occupied(snake_body_t* body, snake_cell_t cell, bool occupied);
+static uint16_t      body_index(const snake_body_t* body, uint16_t part);
+static coordinates_t body_get(const snake_body_t* body, uint16_t part);
+static void          add_head(snake_body_t* body, coordinates_t new_head);
+static void          add_head_remove_tail(snake_body_t* body, coordinates_t new_head);
+static bool          is_game_over(const snake_state_t* state, coordinates_t new_head);
+static bool          is_eating(const snake_state_t* state, coordinates_t new_head);
+static move_t        apply_new_head(snake_state_t* state, coordinates_t new_head);
+static move_t        move_left(snake_state_t* state);
+static move_t        move_right(snake_state_t* state);
+static move_t        move_up(snake_state_t* state);
+static move_t        move_down(snake_state_t* state);
+static uint16_t      calc_score(const snake_state_t* state);
+static void          print_score(uint16_t score);
+static uint16_t      load_highscore(void);
+static void          save_highscore(uint16_t score);
+static void          convert_to_matrix(const snake_state_t* state, max7219_fb_t* matrix);
+static void          lcd_start(void);
+static void          food_generate(snake_state_t* state);
+static void          handle_score(const snake_state_t* state);
+static move_t        move_snake(snake_state_t* state);
+static void          start_game(snake_state_t* state);
+static void          snake_init(void* context);
+static game_status_t snake_update(void* context, uint32_t dt_ms, const input_event_t* events, uint8_t event_amount);
+static void          snake_render(const void* context, max7219_fb_t* fb);
+
+const game_t snake_game = {
+    .name       = "Snake",
+    .state_size = sizeof(snake_state_t),
+    .init       = snake_init,
+    .update     = snake_update,
+    .render     = snake_render,
+    .exit       = NULL,
+};
+
+static void snake_init(void* context)
+{
+    snake_state_t* state = context;
 
-    init();
     lcd_start();
-    start_game(&direction);
+    start_game(state);
+}
 
-    while (app_get_user_input() == BUTTON_NONE) {
-        // Wait for user to start the game
+static game_status_t snake_update(void* context, uint32_t dt_ms, const input_event_t* events, uint8_t event_amount)
+{
+    snake_state_t* state   = context;
+    bool           pressed = false;
+
+    for (uint8_t i = 0; i < event_amount; i++) {
+        if (!events[i].pressed) {
+            continue;
+        }
+
+        pressed = true;
+
+        // The latest direction wins
+        if ((state->phase == PHASE_RUNNING) && (events[i].button != BUTTON_CENTER)) {
+            state->direction = events[i].button;
+        }
     }
 
-    do {
-        app_beep(BEEP_SHORT_MS);
-        food_generate();
+    switch (state->phase) {
+    case PHASE_START:
+        if (pressed) {
+            srand(HAL_GetTick());
+            app_beep(BEEP_SHORT_MS);
+            food_generate(state);
 
-        do {
-            for (uint8_t i = 0; i < SNAKE_SEQUENCE_PERIOD_10MS; i++) {
-                button = app_get_user_input(); // Takes 10 ms
+            state->phase           = PHASE_RUNNING;
+            state->step_elapsed_ms = 0;
+        }
 
-                if ((button != BUTTON_NONE) && (button != BUTTON_CENTER)) {
-                    direction = button;
-                }
-            }
+        break;
+
+    case PHASE_RUNNING:
+        state->step_elapsed_ms += dt_ms;
+
+        while (state->step_elapsed_ms >= SNAKE_SEQUENCE_PERIOD_MS) {
+            state->step_elapsed_ms -= SNAKE_SEQUENCE_PERIOD_MS;
+
+            PROFILE_BEGIN(PROFILE_SCOPE_SNAKE_STEP);
+            move_t move_state = move_snake(state);
+            PROFILE_END(PROFILE_SCOPE_SNAKE_STEP);
 
-            move_state = move_snake(direction);
+            if (move_state == MOVE_GAME_OVER) {
+                app_beep(BEEP_LONG_MS);
+                handle_score(state);
 
-            convert_to_matrix(matrix);
+                state->phase = PHASE_GAME_OVER;
+                break;
+            }
 
-            if (max7219_set_matrix(&max7219, matrix) != MAX7219_OK) {
-                for (;;) {
-                } // Error handling...
+            if (move_state == MOVE_EAT) {
+                app_beep(BEEP_SHORT_MS);
+                food_generate(state);
             }
-        } while (move_state == MOVE_NORMAL);
-    } while (move_state != MOVE_GAME_OVER);
+        }
+
+        break;
 
-    app_beep(BEEP_LONG_MS);
-    handle_score();
+    case PHASE_GAME_OVER:
+        if (pressed) {
+            return GAME_EXIT;
+        }
 
-    while (app_get_user_input() == BUTTON_NONE) {
-        // Wait for user to start the game
+        break;
     }
+
+    return GAME_CONTINUE;
 }
 
-static void init(void)
+static void snake_render(const void* context, max7219_fb_t* fb)
 {
-    for (uint8_t i = 0; i < MAX7219_COLUMN_AMOUNT; i++) {
-        for (uint8_t j = 0; j < MAX7219_ROW_AMOUNT; j++) {
-            snake_fields[i][j].col  = i;
-            snake_fields[i][j].row  = j;
-            snake_fields[i][j].next = NULL;
-        }
-    }
+    convert_to_matrix(context, fb);
 }
 
 static void lcd_start(void)
 {
-    char highscore[20] = "";
+    char  highscore[20];
+    fmt_t fmt;
 
-    sprintf(highscore, "Highscore: %d", flash_load_highscore());
+    fmt_init(&fmt, highscore, sizeof(highscore));
+    fmt_str(&fmt, "Highscore: ");
+    fmt_uint(&fmt, load_highscore(), 0, ' ');
 
     app_lcd_print_title();
 
@@ -142,151 +212,213 @@ static void lcd_start(void)
     SSD1306_UpdateScreen();
 }
 
-static void convert_to_matrix(bool matrix[MAX7219_COLUMN_AMOUNT][MAX7219_ROW_AMOUNT])
+static void convert_to_matrix(const snake_state_t* state, max7219_fb_t* matrix)
 {
-    snake_part_t* temp = head;
-
-    app_matrix_clean(matrix);
+    for (uint16_t i = 0; i < state->body.length; i++) {
+        coordinates_t part = body_get(&state->body, i);
 
-    while (temp != NULL) {
-        matrix[temp->col][temp->row] = true;
-        temp                         = temp->next;
+        max7219_fb_set_pixel(matrix, part.col, part.row);
     }
 
-    if (food.col != NO_FOOD) {
-        matrix[food.col][food.row] = true;
+    if (state->food.col != NO_FOOD) {
+        max7219_fb_set_pixel(matrix, state->food.col, state->food.row);
     }
 }
 
-static void food_generate(void)
+/**
+ * @brief Place the food on a uniformly chosen free cell (bounded time, no rejection sampling)
+ */
+static void food_generate(snake_state_t* state)
 {
-    do {
-        food.col = rand() % MAX7219_COLUMN_AMOUNT;
-        food.row = rand() % MAX7219_ROW_AMOUNT;
-    } while (matrix[food.col][food.row] == true);
+    uint16_t free_cells = SNAKE_CELL_AMOUNT - state->body.length;
+
+    state->food.col = NO_FOOD;
+    state->food.row = NO_FOOD;
+
+    if (free_cells == 0) {
+        return;
+    }
+
+    uint16_t selected = rand() % free_cells; // Index of the free cell
+
+    for (uint16_t word = 0; word < SNAKE_OCCUPANCY_WORDS; word++) {
+        uint32_t free = ~state->body.occupancy[word];
+
+        if (word == (SNAKE_OCCUPANCY_WORDS - 1) && (SNAKE_CELL_AMOUNT % 32) != 0) {
+            free &= (1UL << (SNAKE_CELL_AMOUNT % 32)) - 1; // Cells beyond the canvas
+        }
+
+        uint8_t free_amount = popcount(free);
+
+        if (selected >= free_amount) {
+            selected -= free_amount;
+            continue;
+        }
+
+        // Select the n-th set bit: clear the lower ones
+        for (; selected > 0; selected--) {
+            free &= free - 1;
+        }
+
+        snake_cell_t cell = (snake_cell_t)(word * 32 + __builtin_ctz(free));
+
+        state->food.col = SNAKE_CELL_COL(cell);
+        state->food.row = SNAKE_CELL_ROW(cell);
+        return;
+    }
 }
 
 /**
  * @brief Snake move
  *
- * @param direction
+ * @param state
  *
  * @return move_t
  */
-static move_t move_snake(button_t direction)
+static move_t move_snake(snake_state_t* state)
 {
-    switch (direction) {
+    switch (state->direction) {
     case BUTTON_UP:
-        return move_up(&head);
+        return move_up(state);
 
     case BUTTON_DOWN:
-        return move_down(&head);
+        return move_down(state);
 
     case BUTTON_LEFT:
-        return move_left(&head);
+        return move_left(state);
 
     case BUTTON_RIGHT:
-        return move_right(&head);
+        return move_right(state);
 
     default:
         return MOVE_GAME_OVER; // Not reachable
     }
 }
 
-static void handle_score(void)
+static void handle_score(const snake_state_t* state)
 {
-    uint16_t score = calc_score();
+    uint16_t score = calc_score(state);
     print_score(score);
+    telemetry_event(TELEMETRY_EVENT_GAME_OVER, score);
 
-    uint16_t highscore = flash_load_highscore();
+    uint16_t highscore = load_highscore();
 
     if (score > highscore) {
-        flash_save_highscore(score);
+        save_highscore(score);
     }
 }
 
-static void start_game(button_t* direction)
+static void start_game(snake_state_t* state)
 {
     // Start at the middle
-    head       = &snake_fields[MAX7219_COLUMN_AMOUNT / 2][MAX7219_ROW_AMOUNT / 2];
-    head->next = NULL;
+    state->body.head     = 0;
+    state->body.length   = 1;
+    state->body.cells[0] = SNAKE_CELL(MAX7219_COLUMN_AMOUNT / 2, MAX7219_ROW_AMOUNT / 2);
 
-    food.col = NO_FOOD;
-    food.row = NO_FOOD;
+    for (uint8_t i = 0; i < SNAKE_OCCUPANCY_WORDS; i++) {
+        state->body.occupancy[i] = 0;
+    }
 
-    convert_to_matrix(matrix);
+    set_occupied(&state->body, state->body.cells[0], true);
 
-    if (max7219_set_matrix(&max7219, matrix) != MAX7219_OK) {
-        for (;;) {
-        } // Error handling...
-    }
+    state->food.col = NO_FOOD;
+    state->food.row = NO_FOOD;
 
-    *direction = BUTTON_RIGHT;
+    state->direction = BUTTON_RIGHT;
+    state->phase     = PHASE_START;
 }
 
-static void add_head(snake_part_t** snake_head, coordinates_t new_head)
+static uint8_t popcount(uint32_t word)
 {
-    snake_part_t* new_head_node = &snake_fields[new_head.col][new_head.row];
+    // No popcount instruction on the Cortex-M0
+    word = word - ((word >> 1) & 0x55555555UL);
+    word = (word & 0x33333333UL) + ((word >> 2) & 0x33333333UL);
+    word = (word + (word >> 4)) & 0x0F0F0F0FUL;
 
-    new_head_node->next = *snake_head;
+    return (uint8_t)((word * 0x01010101UL) >> 24);
+}
 
-    *snake_head = new_head_node;
+static bool is_occupied(const snake_body_t* body, snake_cell_t cell)
+{
+    return (body->occupancy[cell / 32] & (1UL << (cell % 32))) != 0;
 }
 
-static void add_head_remove_tail(snake_part_t** snake_head, coordinates_t new_head)
+static void set_occupied(snake_body_t* body, snake_cell_t cell, bool occupied)
 {
-    snake_part_t* temp;
-    snake_part_t* new_head_node = &snake_fields[new_head.col][new_head.row];
+    if (occupied) {
+        body->occupancy[cell / 32] |= (1UL << (cell % 32));
+    } else {
+        body->occupancy[cell / 32] &= ~(1UL << (cell % 32));
+    }
+}
 
-    new_head_node->next = *snake_head;
+/**
+ * @brief Ring buffer index of a snake part
+ *
+ * @param body
+ * @param part -- 0: head; length - 1: tail
+ *
+ * @return uint16_t
+ */
+static uint16_t body_index(const snake_body_t* body, uint16_t part)
+{
+    return (body->head >= part) ? (body->head - part) : (body->head + MAX_SNAKE_LENGTH - part);
+}
 
-    if ((*snake_head)->next == NULL) {
-        // The snake had only one part
-        new_head_node->next = NULL;
-        *snake_head         = new_head_node;
-        return;
-    }
+static coordinates_t body_get(const snake_body_t* body, uint16_t part)
+{
+    snake_cell_t  cell        = body->cells[body_index(body, part)];
+    coordinates_t coordinates = { .col = SNAKE_CELL_COL(cell), .row = SNAKE_CELL_ROW(cell) };
 
-    temp = *snake_head;
+    return coordinates;
+}
 
-    while (temp->next->next != NULL) {
-        temp = temp->next;
-    }
+static void add_head(snake_body_t* body, coordinates_t new_head)
+{
+    snake_cell_t cell = SNAKE_CELL(new_head.col, new_head.row);
+
+    body->head = (body->head + 1 < MAX_SNAKE_LENGTH) ? (body->head + 1) : 0;
 
-    // Remove last part
-    temp->next = NULL;
+    body->cells[body->head] = cell;
+    body->length++;
 
-    *snake_head = new_head_node;
+    set_occupied(body, cell, true);
+}
+
+static void add_head_remove_tail(snake_body_t* body, coordinates_t new_head)
+{
+    snake_cell_t cell = SNAKE_CELL(new_head.col, new_head.row);
+
+    set_occupied(body, body->cells[body_index(body, body->length - 1)], false);
+
+    // The tail is defined by head and length, moving the head drops the last part
+    body->head = (body->head + 1 < MAX_SNAKE_LENGTH) ? (body->head + 1) : 0;
+
+    body->cells[body->head] = cell;
+
+    set_occupied(body, cell, true);
 }
 
 /**
  * @brief Check if the game is over
  *
+ * @param state
  * @param new_head
  *
  * @return true  -- The game is over
  * @return false -- The game is not over
  */
-static bool is_game_over(coordinates_t new_head)
+static bool is_game_over(const snake_state_t* state, coordinates_t new_head)
 {
     if ((new_head.col >= MAX7219_COLUMN_AMOUNT) || (new_head.row >= MAX7219_ROW_AMOUNT)) {
         return true;
     }
 
-    uint8_t       snake_length = 0;
-    snake_part_t* temp         = head;
-
-    while (temp != NULL) {
-        if ((temp->col == new_head.col) && (temp->row == new_head.row)) {
-            return true;
-        }
-
-        temp = temp->next;
-
-        ++snake_length;
+    if (is_occupied(&state->body, SNAKE_CELL(new_head.col, new_head.row))) {
+        return true; // Hit itself
     }
 
-    if (snake_length >= MAX_SNAKE_LENGTH) {
+    if (state->body.length >= MAX_SNAKE_LENGTH) {
         return true;
     }
 
@@ -296,37 +428,38 @@ static bool is_game_over(coordinates_t new_head)
 /**
  * @brief Check if the snake is eating food
  *
+ * @param state
  * @param new_head
  *
  * @return true  -- The snake is eating food
  * @return false -- The snake is not eating food
  */
-static bool is_eating(coordinates_t new_head)
+static bool is_eating(const snake_state_t* state, coordinates_t new_head)
 {
-    return (new_head.col == food.col) && (new_head.row == food.row);
+    return (new_head.col == state->food.col) && (new_head.row == state->food.row);
 }
 
 /**
  * @brief Apply the new head and do checks for eating food and game over
  *
- * @param snake_head
+ * @param state
  * @param new_head
  *
  * @return move_t
  */
-static move_t apply_new_head(snake_part_t** snake_head, coordinates_t new_head)
+static move_t apply_new_head(snake_state_t* state, coordinates_t new_head)
 {
-    if (is_game_over(new_head)) {
+    if (is_game_over(state, new_head)) {
         return MOVE_GAME_OVER;
     }
 
-    if (is_eating(new_head)) {
+    if (is_eating(state, new_head)) {
         // Eating food
-        add_head(snake_head, new_head);
+        add_head(&state->body, new_head);
         return MOVE_EAT;
     }
 
-    add_head_remove_tail(snake_head, new_head);
+    add_head_remove_tail(&state->body, new_head);
 
     return MOVE_NORMAL;
 }
@@ -334,123 +467,108 @@ static move_t apply_new_head(snake_part_t** snake_head, coordinates_t new_head)
 /**
  * @brief Move snake left
  *
- * @param snake_head
+ * @param state
  *
  * @return move_t
  */
-static move_t move_left(snake_part_t** snake_head)
+static move_t move_left(snake_state_t* state)
 {
+    coordinates_t head = body_get(&state->body, 0);
     coordinates_t new_head;
 
-    new_head.col = (*snake_head)->col - 1;
-    new_head.row = (*snake_head)->row;
+    new_head.col = head.col - 1;
+    new_head.row = head.row;
 
-    return apply_new_head(snake_head, new_head);
+    return apply_new_head(state, new_head);
 }
 
 /**
  * @brief Move snake right
  *
- * @param snake_head
+ * @param state
  *
  * @return move_t
  */
-static move_t move_right(snake_part_t** snake_head)
+static move_t move_right(snake_state_t* state)
 {
+    coordinates_t head = body_get(&state->body, 0);
     coordinates_t new_head;
 
-    new_head.col = (*snake_head)->col + 1;
-    new_head.row = (*snake_head)->row;
+    new_head.col = head.col + 1;
+    new_head.row = head.row;
 
-    return apply_new_head(snake_head, new_head);
+    return apply_new_head(state, new_head);
 }
 
 /**
  * @brief Move snake up
  *
- * @param snake_head
+ * @param state
  *
  * @return move_t
  */
-static move_t move_up(snake_part_t** snake_head)
+static move_t move_up(snake_state_t* state)
 {
+    coordinates_t head = body_get(&state->body, 0);
     coordinates_t new_head;
 
-    new_head.col = (*snake_head)->col;
-    new_head.row = (*snake_head)->row - 1;
+    new_head.col = head.col;
+    new_head.row = head.row - 1;
 
-    return apply_new_head(snake_head, new_head);
+    return apply_new_head(state, new_head);
 }
 
 /**
  * @brief Move snake down
  *
- * @param snake_head
+ * @param state
  *
  * @return move_t
  */
-static move_t move_down(snake_part_t** snake_head)
+static move_t move_down(snake_state_t* state)
 {
+    coordinates_t head = body_get(&state->body, 0);
     coordinates_t new_head;
 
-    new_head.col = (*snake_head)->col;
-    new_head.row = (*snake_head)->row + 1;
+    new_head.col = head.col;
+    new_head.row = head.row + 1;
 
-    return apply_new_head(snake_head, new_head);
+    return apply_new_head(state, new_head);
 }
 
-static uint8_t calc_score(void)
+static uint16_t calc_score(const snake_state_t* state)
 {
-    uint8_t       score = 0;
-    snake_part_t* temp  = head;
-
-    while (temp != NULL) {
-        score++;
-        temp = temp->next;
-    }
-
-    return score;
+    return state->body.length;
 }
 
 static void print_score(uint16_t score)
 {
-    char string[20] = "";
+    char  string[20];
+    fmt_t fmt;
 
-    sprintf(string, "Score: %d", score);
+    fmt_init(&fmt, string, sizeof(string));
+    fmt_str(&fmt, "Score: ");
+    fmt_uint(&fmt, score, 0, ' ');
 
     SSD1306_GotoXY(0, APP_LCD_ROW_GAME_DYNAMIC_1);
     SSD1306_Puts(string, &Font_7x10, 1);
-    SSD1306_UpdateScreen();
 }
 
 /**
- * @brief Initialize the highscore in flash memory, if not yet done
+ * @brief Load the highscore from the storage (0 if there is none yet)
  */
-static void flash_init_highscore(void)
+static uint16_t load_highscore(void)
 {
-    if (flash_load_highscore() == 0xFFFF) {
-        flash_save_highscore(0);
+    uint32_t highscore = 0;
+
+    if (storage_read(STORAGE_KEY_SNAKE_HIGHSCORE, &highscore) != STORAGE_OK) {
+        return 0; // No highscore yet
     }
-}
 
-static uint16_t flash_load_highscore(void)
-{
-    return *((uint16_t*)FLASH_HIGHSCORE_ADDRESS); // Read stored value
+    return (uint16_t)highscore;
 }
 
-static void flash_save_highscore(uint16_t score)
+static void save_highscore(uint16_t score)
 {
-    HAL_FLASH_Unlock(); // Unlock flash for writing
-
-    FLASH_EraseInitTypeDef EraseInitStruct;
-    uint32_t               PageError = 0;
-
-    EraseInitStruct.TypeErase   = FLASH_TYPEERASE_PAGES;
-    EraseInitStruct.PageAddress = FLASH_HIGHSCORE_ADDRESS;
-    EraseInitStruct.NbPages     = 1;
-    HAL_FLASHEx_Erase(&EraseInitStruct, &PageError); // Erase before writing
-
-    HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD, FLASH_HIGHSCORE_ADDRESS, score);
-
-    HAL_FLASH_Lock(); // Lock flash after writing
+    storage_write(STORAGE_KEY_SNAKE_HIGHSCORE, score);
 }
@@ -9,6 +9,8 @@
 #ifndef SNAKE_H_
 #define SNAKE_H_
 
-void snake(void);
+#include "game.h"
+
+extern const game_t snake_game;
 
 #endif /* SNAKE_H_ */
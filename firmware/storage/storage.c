@@ -0,0 +1,332 @@
+/**
+ * @file storage.c
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ * Page layout:
+ *   Header: magic, sequence, ~sequence, reserved (halfwords)
+ *   Record: key, value (low), value (high), CRC16 of the first three halfwords
+ *
+ * The page with a valid header and the newer sequence is the active one. Compaction writes the header of the new page
+ * last, so an interrupted compaction leaves the previous page active.
+ */
+
+#include "storage.h"
+
+#define HEADER_MAGIC 0x4B56 // "KV"
+#define KEY_ERASED   0xFFFF
+
+#define RECORD_HALFWORDS (STORAGE_RECORD_SIZE / 2)
+#define HEADER_HALFWORDS (STORAGE_HEADER_SIZE / 2)
+
+static uintptr_t       active_page     = 0; // 0: not initialized
+static uint16_t        active_sequence = 0;
+static uint16_t        write_index     = 0; // Next free record of the active page
+static storage_stats_t stats           = { 0 };
+
+static uint16_t read_halfword(uintptr_t address)
+{
+    return *(const volatile uint16_t*)address;
+}
+
+static uintptr_t record_address(uintptr_t page, uint16_t index)
+{
+    return page + STORAGE_HEADER_SIZE + (uintptr_t)index * STORAGE_RECORD_SIZE;
+}
+
+static uintptr_t other_page(uintptr_t page)
+{
+    return (page == STORAGE_PAGE_0_ADDRESS) ? STORAGE_PAGE_1_ADDRESS : STORAGE_PAGE_0_ADDRESS;
+}
+
+/**
+ * @brief CRC-16/CCITT-FALSE over halfwords (low byte first)
+ */
+static uint16_t crc16(const uint16_t* data, uint8_t amount)
+{
+    uint16_t crc = 0xFFFF;
+
+    for (uint8_t i = 0; i < 2 * amount; i++) {
+        uint8_t byte = (i & 1) ? (data[i / 2] >> 8) : (data[i / 2] & 0xFF);
+
+        crc ^= (uint16_t)byte << 8;
+
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+static bool page_valid(uintptr_t page, uint16_t* sequence)
+{
+    uint16_t magic        = read_halfword(page);
+    uint16_t sequence_raw = read_halfword(page + 2);
+    uint16_t sequence_inv = read_halfword(page + 4);
+
+    if ((magic != HEADER_MAGIC) || ((sequence_raw ^ sequence_inv) != 0xFFFF)) {
+        return false;
+    }
+
+    *sequence = sequence_raw;
+
+    return true;
+}
+
+/**
+ * @brief Read a record
+ *
+ * @return true  -- Record is valid
+ * @return false -- Record is erased or corrupted (e.g., interrupted write)
+ */
+static bool record_read(uintptr_t page, uint16_t index, uint16_t* key, uint32_t* value)
+{
+    uintptr_t address = record_address(page, index);
+    uint16_t  data[RECORD_HALFWORDS];
+
+    for (uint8_t i = 0; i < RECORD_HALFWORDS; i++) {
+        data[i] = read_halfword(address + 2 * i);
+    }
+
+    if ((data[0] == KEY_ERASED) || (crc16(data, RECORD_HALFWORDS - 1) != data[RECORD_HALFWORDS - 1])) {
+        return false;
+    }
+
+    *key   = data[0];
+    *value = ((uint32_t)data[2] << 16) | data[1];
+
+    return true;
+}
+
+static uint16_t find_write_index(uintptr_t page)
+{
+    uint16_t index = 0;
+
+    // Append only: all records after the first erased one are erased too
+    while ((index < STORAGE_RECORD_AMOUNT) && (read_halfword(record_address(page, index)) != KEY_ERASED)) {
+        index++;
+    }
+
+    return index;
+}
+
+static storage_error_t find_latest(uintptr_t page, uint16_t end, uint16_t key, uint32_t* value)
+{
+    for (uint16_t i = end; i > 0; i--) {
+        uint16_t record_key;
+        uint32_t record_value;
+
+        if (record_read(page, i - 1, &record_key, &record_value) && (record_key == key)) {
+            *value = record_value;
+            return STORAGE_OK;
+        }
+    }
+
+    return STORAGE_NOT_FOUND;
+}
+
+static storage_error_t program(uintptr_t address, const uint16_t* data, uint8_t amount)
+{
+    storage_error_t error_code = STORAGE_OK;
+
+    HAL_FLASH_Unlock();
+
+    for (uint8_t i = 0; i < amount; i++) {
+        if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD, address + 2 * i, data[i]) != HAL_OK) {
+            error_code = STORAGE_ERROR;
+            break;
+        }
+    }
+
+    HAL_FLASH_Lock();
+
+    return error_code;
+}
+
+static storage_error_t erase(uintptr_t page)
+{
+    FLASH_EraseInitTypeDef EraseInitStruct;
+    uint32_t               PageError = 0;
+    HAL_StatusTypeDef      status;
+
+    EraseInitStruct.TypeErase   = FLASH_TYPEERASE_PAGES;
+    EraseInitStruct.PageAddress = (uint32_t)page;
+    EraseInitStruct.NbPages     = 1;
+
+    HAL_FLASH_Unlock();
+    status = HAL_FLASHEx_Erase(&EraseInitStruct, &PageError);
+    HAL_FLASH_Lock();
+
+    stats.page_erases++;
+
+    return (status == HAL_OK) ? STORAGE_OK : STORAGE_ERROR;
+}
+
+static storage_error_t write_record(uintptr_t page, uint16_t index, uint16_t key, uint32_t value)
+{
+    uint16_t data[RECORD_HALFWORDS] = { key, (uint16_t)value, (uint16_t)(value >> 16), 0 };
+
+    data[RECORD_HALFWORDS - 1] = crc16(data, RECORD_HALFWORDS - 1);
+
+    return program(record_address(page, index), data, RECORD_HALFWORDS);
+}
+
+static storage_error_t write_header(uintptr_t page, uint16_t sequence)
+{
+    uint16_t data[HEADER_HALFWORDS] = { HEADER_MAGIC, sequence, (uint16_t)~sequence, 0xFFFF };
+
+    return program(page, data, HEADER_HALFWORDS - 1); // Reserved halfword stays erased
+}
+
+static storage_error_t format(uintptr_t page, uint16_t sequence)
+{
+    if (erase(page) != STORAGE_OK) {
+        return STORAGE_ERROR;
+    }
+
+    if (write_header(page, sequence) != STORAGE_OK) {
+        return STORAGE_ERROR;
+    }
+
+    active_page     = page;
+    active_sequence = sequence;
+    write_index     = 0;
+
+    return STORAGE_OK;
+}
+
+/**
+ * @brief Copy the latest record of every key (and the new record) into the other page and activate it
+ */
+static storage_error_t compact(uint16_t key, uint32_t value)
+{
+    uintptr_t target = other_page(active_page);
+    uint16_t  index  = 0;
+
+    if (erase(target) != STORAGE_OK) {
+        return STORAGE_ERROR;
+    }
+
+    if (write_record(target, index++, key, value) != STORAGE_OK) {
+        return STORAGE_ERROR;
+    }
+
+    for (uint16_t i = write_index; i > 0; i--) {
+        uint16_t record_key;
+        uint32_t record_value;
+        uint32_t copied_value;
+
+        if (!record_read(active_page, i - 1, &record_key, &record_value)) {
+            continue;
+        }
+
+        if (find_latest(target, index, record_key, &copied_value) == STORAGE_OK) {
+            continue; // A newer record of this key is already copied
+        }
+
+        if (index >= STORAGE_RECORD_AMOUNT) {
+            return STORAGE_FULL; // The previous page stays active
+        }
+
+        if (write_record(target, index++, record_key, record_value) != STORAGE_OK) {
+            return STORAGE_ERROR;
+        }
+    }
+
+    // Activate the new page
+    if (write_header(target, active_sequence + 1) != STORAGE_OK) {
+        return STORAGE_ERROR;
+    }
+
+    active_page = target;
+    active_sequence++;
+    write_index = index;
+
+    return STORAGE_OK;
+}
+
+storage_error_t storage_init(void)
+{
+    uint16_t sequence_0;
+    uint16_t sequence_1;
+    bool     valid_0 = page_valid(STORAGE_PAGE_0_ADDRESS, &sequence_0);
+    bool     valid_1 = page_valid(STORAGE_PAGE_1_ADDRESS, &sequence_1);
+
+    if (valid_0 && (!valid_1 || ((int16_t)(sequence_0 - sequence_1) > 0))) {
+        active_page     = STORAGE_PAGE_0_ADDRESS;
+        active_sequence = sequence_0;
+    } else if (valid_1) {
+        active_page     = STORAGE_PAGE_1_ADDRESS;
+        active_sequence = sequence_1;
+    } else {
+        // First start: format and take over the highscore of the old firmware (located inside page 1)
+        uint16_t legacy_highscore = read_halfword(STORAGE_LEGACY_HIGHSCORE_ADDRESS);
+
+        if (format(STORAGE_PAGE_0_ADDRESS, 1) != STORAGE_OK) {
+            active_page = 0;
+            return STORAGE_ERROR;
+        }
+
+        if (legacy_highscore != 0xFFFF) {
+            return storage_write(STORAGE_KEY_SNAKE_HIGHSCORE, legacy_highscore);
+        }
+
+        return STORAGE_OK;
+    }
+
+    write_index = find_write_index(active_page);
+
+    return STORAGE_OK;
+}
+
+storage_error_t storage_read(uint16_t key, uint32_t* value)
+{
+    if (active_page == 0) {
+        return STORAGE_NOT_INITIALIZED;
+    }
+
+    if (key == KEY_ERASED) {
+        return STORAGE_INVALID_KEY;
+    }
+
+    return find_latest(active_page, write_index, key, value);
+}
+
+storage_error_t storage_write(uint16_t key, uint32_t value)
+{
+    uint32_t        current_value;
+    storage_error_t error_code;
+
+    if (active_page == 0) {
+        return STORAGE_NOT_INITIALIZED;
+    }
+
+    if (key == KEY_ERASED) {
+        return STORAGE_INVALID_KEY;
+    }
+
+    if ((find_latest(active_page, write_index, key, &current_value) == STORAGE_OK) && (current_value == value)) {
+        stats.writes_skipped++;
+        return STORAGE_OK;
+    }
+
+    if (write_index >= STORAGE_RECORD_AMOUNT) {
+        error_code = compact(key, value);
+    } else {
+        error_code = write_record(active_page, write_index, key, value);
+        write_index++; // The slot is used, even if programming failed
+    }
+
+    if (error_code == STORAGE_OK) {
+        stats.records_written++;
+    }
+
+    return error_code;
+}
+
+void storage_get_stats(storage_stats_t* stats_out)
+{
+    *stats_out = stats;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file storage.h
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ */
+
+#ifndef STORAGE_H_
+#define STORAGE_H_
+
+#include "stm32f0xx_hal.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Log-structured key-value store over two flash pages (reserved at the end of the flash, see linker script). Records
+ * are appended to the active page; the latest valid record of a key wins. Only when the active page is full, the
+ * latest records are compacted into the other page, which is the only time a page is erased.
+ */
+#ifndef STORAGE_PAGE_0_ADDRESS
+#define STORAGE_PAGE_0_ADDRESS ((uintptr_t)0x08007800)
+#endif
+
+#ifndef STORAGE_PAGE_1_ADDRESS
+#define STORAGE_PAGE_1_ADDRESS ((uintptr_t)0x08007C00)
+#endif
+
+#ifndef STORAGE_PAGE_SIZE
+#define STORAGE_PAGE_SIZE 1024 // [bytes]
+#endif
+
+#ifndef STORAGE_LEGACY_HIGHSCORE_ADDRESS
+#define STORAGE_LEGACY_HIGHSCORE_ADDRESS ((uintptr_t)0x08007F00) // Snake highscore of firmware <= v1.3
+#endif
+
+#define STORAGE_RECORD_SIZE   8 // key, value (2 halfwords), CRC16 [bytes]
+#define STORAGE_HEADER_SIZE   8 // [bytes]
+#define STORAGE_RECORD_AMOUNT ((STORAGE_PAGE_SIZE - STORAGE_HEADER_SIZE) / STORAGE_RECORD_SIZE) // Records per page
+
+#define STORAGE_KEY(namespace, field) ((uint16_t)(((uint16_t)(namespace) << 8) | (uint8_t)(field)))
+
+// Keys in use (keep unique!)
+#define STORAGE_KEY_SNAKE_HIGHSCORE STORAGE_KEY(STORAGE_NAMESPACE_SNAKE, 0)
+#define STORAGE_KEY_TICTACTOE_MODE  STORAGE_KEY(STORAGE_NAMESPACE_TICTACTOE, 0)
+
+/**
+ * @brief Key namespaces (one per game)
+ */
+typedef enum {
+    STORAGE_NAMESPACE_APP       = 0x00,
+    STORAGE_NAMESPACE_SNAKE     = 0x01,
+    STORAGE_NAMESPACE_TICTACTOE = 0x02,
+    STORAGE_NAMESPACE_DRAWING   = 0x03,
+} storage_namespace_t;
+
+/**
+ * @brief Storage error codes
+ */
+typedef enum {
+    STORAGE_OK = 0,
+    STORAGE_ERROR,         // Flash erase/program failed
+    STORAGE_NOT_FOUND,     // No valid record for the key
+    STORAGE_FULL,          // Too many different keys for one page
+    STORAGE_INVALID_KEY,   // Key 0xFFFF is reserved (erased flash)
+    STORAGE_NOT_INITIALIZED,
+} storage_error_t;
+
+/**
+ * @brief Storage statistics (since storage_init())
+ */
+typedef struct {
+    uint32_t records_written; // Appended records
+    uint32_t writes_skipped;  // Writes of an unchanged value
+    uint32_t page_erases;     // Erased pages (formatting and compaction)
+} storage_stats_t;
+
+/**
+ * @brief Initialize the storage (finds the active page, formats the flash and migrates the legacy highscore if
+ *        no valid page exists)
+ *
+ * @return storage_error_t -- Error code
+ */
+storage_error_t storage_init(void);
+
+/**
+ * @brief Read the latest value of a key
+ *
+ * @param[in]  key   -- Key, see STORAGE_KEY()
+ * @param[out] value -- Value
+ *
+ * @return storage_error_t -- Error code
+ */
+storage_error_t storage_read(uint16_t key, uint32_t* value);
+
+/**
+ * @brief Write a value (nothing is written if the value did not change)
+ *
+ * @param[in] key   -- Key, see STORAGE_KEY()
+ * @param[in] value -- Value
+ *
+ * @return storage_error_t -- Error code
+ */
+storage_error_t storage_write(uint16_t key, uint32_t value);
+
+/**
+ * @brief Get the storage statistics
+ *
+ * @param[out] stats -- Statistics
+ */
+void storage_get_stats(storage_stats_t* stats);
+
+#endif /* STORAGE_H_ */
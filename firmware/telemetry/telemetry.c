@@ -0,0 +1,374 @@
+/**
+ * @file telemetry.c
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ * The interrupt lock of a record only covers the sequence number and the reservation of its ring buffer space (the frame
+ * length is known in advance, see TELEMETRY_FRAME_SIZE()); the CRC, the COBS encoding and the copy run unlocked, so the
+ * UART RX interrupt (remote control) is not held off. A record sent from an interrupt may be written while the main
+ * loop is copying its own one; the write index is only published once the last writer is done. The DMA sends the ring
+ * buffer in chunks straight from its memory; the read index is only advanced when a chunk is complete, so the producer
+ * cannot overwrite bytes which are still in flight.
+ */
+
+#include "telemetry.h"
+
+#include <string.h>
+
+#include "profile.h"
+
+#define BUFFER_MASK (TELEMETRY_BUFFER_SIZE - 1)
+
+#define HEADER_SIZE 6                                         // type, sequence, time
+#define RECORD_SIZE (HEADER_SIZE + TELEMETRY_MAX_PAYLOAD + 1) // Incl. CRC
+#define FRAME_SIZE  TELEMETRY_FRAME_SIZE(TELEMETRY_MAX_PAYLOAD)
+
+_Static_assert((TELEMETRY_BUFFER_SIZE & BUFFER_MASK) == 0, "TELEMETRY_BUFFER_SIZE must be a power of two");
+_Static_assert(TELEMETRY_BUFFER_SIZE <= 0x8000, "Free-running 16-bit indices");
+_Static_assert(RECORD_SIZE < 254, "One COBS block per record, see TELEMETRY_FRAME_SIZE()");
+
+#if PROFILE_ENABLED
+#define REPORT_AMOUNT (1 + PROFILE_SCOPE_AMOUNT + 1 + PROFILE_BUS_AMOUNT) // Scheduler, scopes, frame, buses
+#else
+#define REPORT_AMOUNT 1 // Scheduler
+#endif
+
+static UART_HandleTypeDef* uart = NULL;
+
+static uint8_t           ring[TELEMETRY_BUFFER_SIZE];
+static volatile uint16_t head       = 0; // Write index, published for the DMA (free-running)
+static volatile uint16_t reserved   = 0; // End of the reserved space (free-running)
+static volatile uint8_t  writers    = 0; // Records being written between head and reserved
+static volatile uint16_t tail       = 0; // Read index (free-running)
+static volatile uint16_t dma_length = 0; // Bytes of the running DMA transfer (0: idle)
+static volatile bool     paused     = false;
+
+static uint8_t           sequence     = 0;
+static uint8_t           report_index = 0;
+static telemetry_stats_t stats        = { 0 };
+
+static uint8_t* put_u16(uint8_t* data, uint16_t value)
+{
+    data[0] = (uint8_t)value;
+    data[1] = (uint8_t)(value >> 8);
+
+    return data + 2;
+}
+
+static uint8_t* put_u32(uint8_t* data, uint32_t value)
+{
+    data = put_u16(data, (uint16_t)value);
+
+    return put_u16(data, (uint16_t)(value >> 16));
+}
+
+/**
+ * @brief CRC-8 (poly 0x07, init 0x00)
+ */
+static uint8_t crc8(const uint8_t* data, uint8_t length)
+{
+    uint8_t crc = 0;
+
+    for (uint8_t i = 0; i < length; i++) {
+        crc ^= data[i];
+
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+/**
+ * @brief Consistent overhead byte stuffing: removes all zeros, so 0x00 can delimit the frames
+ *
+ * @return uint8_t -- Encoded length incl. the delimiter [bytes]
+ */
+static uint8_t cobs_encode(const uint8_t* data, uint8_t length, uint8_t* frame)
+{
+    uint8_t code_index = 0;
+    uint8_t out        = 1;
+    uint8_t code       = 1;
+
+    for (uint8_t i = 0; i < length; i++) {
+        if (data[i] != 0) {
+            frame[out++] = data[i];
+            code++;
+        }
+
+        if ((data[i] == 0) || (code == 0xFF)) {
+            frame[code_index] = code;
+            code_index        = out++;
+            code              = 1;
+        }
+    }
+
+    frame[code_index] = code;
+    frame[out++]      = 0x00;
+
+    return out;
+}
+
+/**
+ * @brief Start the next DMA chunk if idle (interrupts must be locked)
+ */
+static void start_transfer(void)
+{
+    uint16_t pending = (uint16_t)(head - tail);
+    uint16_t offset  = tail & BUFFER_MASK;
+    uint16_t length  = TELEMETRY_BUFFER_SIZE - offset; // Up to the end of the ring buffer
+
+    if ((dma_length != 0) || paused || (pending == 0)) {
+        return;
+    }
+
+    if (length > pending) {
+        length = pending;
+    }
+
+    if (length > TELEMETRY_DMA_CHUNK_SIZE) {
+        length = TELEMETRY_DMA_CHUNK_SIZE;
+    }
+
+    dma_length = length;
+
+    if (HAL_UART_Transmit_DMA(uart, &ring[offset], length) != HAL_OK) {
+        dma_length = 0; // Retried with the next record
+        stats.errors++;
+    }
+}
+
+static void chunk_done(void)
+{
+    tail += dma_length;
+    dma_length = 0;
+
+    start_transfer();
+}
+
+void telemetry_init(UART_HandleTypeDef* uart_in)
+{
+    uint8_t payload[4];
+
+    uart         = uart_in;
+    head         = 0;
+    reserved     = 0;
+    writers      = 0;
+    tail         = 0;
+    dma_length   = 0;
+    paused       = false;
+    sequence     = 0;
+    report_index = 0;
+    stats        = (telemetry_stats_t) { 0 };
+
+    put_u32(payload, uart->Init.BaudRate);
+    telemetry_send(TELEMETRY_RECORD_BOOT, payload, sizeof(payload));
+}
+
+bool telemetry_send(telemetry_record_t type, const uint8_t* payload, uint8_t length)
+{
+    uint8_t  record[RECORD_SIZE];
+    uint8_t  frame[FRAME_SIZE];
+    uint8_t  frame_length = TELEMETRY_FRAME_SIZE(length);
+    uint16_t offset;
+
+    if ((uart == NULL) || (length > TELEMETRY_MAX_PAYLOAD)) {
+        return false;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    record[1] = sequence++; // Also counts dropped records
+
+    if ((uint16_t)(TELEMETRY_BUFFER_SIZE - (uint16_t)(reserved - tail)) < frame_length) {
+        stats.dropped++;
+        __set_PRIMASK(primask);
+        return false;
+    }
+
+    put_u32(&record[2], HAL_GetTick());
+    offset = reserved;
+    reserved += frame_length;
+    writers++;
+
+    __set_PRIMASK(primask);
+
+    record[0] = (uint8_t)type;
+    memcpy(&record[HEADER_SIZE], payload, length);
+    record[HEADER_SIZE + length] = crc8(record, HEADER_SIZE + length);
+
+    cobs_encode(record, HEADER_SIZE + length + 1, frame);
+
+    for (uint8_t i = 0; i < frame_length; i++) {
+        ring[(offset + i) & BUFFER_MASK] = frame[i];
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    stats.records++;
+
+    if (--writers == 0) {
+        head = reserved;
+        start_transfer();
+    }
+
+    __set_PRIMASK(primask);
+
+    return true;
+}
+
+void telemetry_event(telemetry_event_t event, uint16_t argument)
+{
+    uint8_t payload[3];
+
+    payload[0] = (uint8_t)event;
+    put_u16(&payload[1], argument);
+
+    telemetry_send(TELEMETRY_RECORD_EVENT, payload, sizeof(payload));
+}
+
+void telemetry_error(telemetry_source_t source, uint8_t code)
+{
+    uint8_t payload[2] = { (uint8_t)source, code };
+
+    telemetry_send(TELEMETRY_RECORD_ERROR, payload, sizeof(payload));
+}
+
+void telemetry_baud(uint32_t baud)
+{
+    uint8_t payload[4];
+
+    put_u32(payload, baud);
+
+    telemetry_send(TELEMETRY_RECORD_BAUD, payload, sizeof(payload));
+}
+
+#if PROFILE_ENABLED
+
+static uint8_t* put_timing(uint8_t* data, const profile_timing_t* timing)
+{
+    data = put_u32(data, timing->count);
+    data = put_u32(data, timing->min_us);
+    data = put_u32(data, timing->avg_us);
+
+    return put_u32(data, timing->max_us);
+}
+
+static void report_profile(uint8_t index)
+{
+    uint8_t  payload[TELEMETRY_MAX_PAYLOAD];
+    uint8_t* end = payload;
+
+    if (index < PROFILE_SCOPE_AMOUNT) {
+        profile_timing_t timing;
+
+        profile_get_scope((profile_scope_t)index, &timing);
+        *end++ = index;
+        end    = put_timing(end, &timing);
+
+        telemetry_send(TELEMETRY_RECORD_PROFILE_SCOPE, payload, (uint8_t)(end - payload));
+    } else if (index == PROFILE_SCOPE_AMOUNT) {
+        profile_frame_t frame;
+
+        profile_get_frame(&frame);
+        end = put_timing(end, &frame.time);
+        end = put_u32(end, frame.budget_us);
+        end = put_u32(end, frame.over_budget);
+
+        telemetry_send(TELEMETRY_RECORD_PROFILE_FRAME, payload, (uint8_t)(end - payload));
+    } else {
+        profile_bus_stats_t bus;
+        uint8_t             bus_index = index - PROFILE_SCOPE_AMOUNT - 1;
+
+        profile_get_bus((profile_bus_t)bus_index, &bus);
+        *end++ = bus_index;
+        end    = put_u32(end, bus.transactions);
+        end    = put_u32(end, bus.bytes);
+
+        telemetry_send(TELEMETRY_RECORD_PROFILE_BUS, payload, (uint8_t)(end - payload));
+    }
+}
+
+#endif /* PROFILE_ENABLED */
+
+void telemetry_report(const scheduler_stats_t* scheduler)
+{
+    if (report_index == 0) {
+        uint8_t  payload[5 * sizeof(uint32_t)];
+        uint8_t* end = payload;
+
+        end = put_u32(end, scheduler->updates);
+        end = put_u32(end, scheduler->renders);
+        end = put_u32(end, scheduler->late_updates);
+        end = put_u32(end, scheduler->overruns);
+        end = put_u32(end, scheduler->dropped_ticks);
+
+        telemetry_send(TELEMETRY_RECORD_SCHEDULER, payload, (uint8_t)(end - payload));
+    }
+#if PROFILE_ENABLED
+    else {
+        report_profile(report_index - 1);
+    }
+#endif
+
+    report_index = (uint8_t)((report_index + 1) % REPORT_AMOUNT);
+}
+
+void telemetry_pause(void)
+{
+    paused = true;
+}
+
+void telemetry_resume(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    paused = false;
+
+    if (uart != NULL) {
+        start_transfer();
+    }
+
+    __set_PRIMASK(primask);
+}
+
+bool telemetry_is_busy(void)
+{
+    return dma_length != 0;
+}
+
+uint16_t telemetry_get_free(void)
+{
+    if (uart == NULL) {
+        return 0;
+    }
+
+    return (uint16_t)(TELEMETRY_BUFFER_SIZE - (uint16_t)(reserved - tail));
+}
+
+bool telemetry_is_empty(void)
+{
+    return reserved == tail;
+}
+
+void telemetry_uart_tx_complete(void)
+{
+    chunk_done();
+}
+
+void telemetry_uart_error(void)
+{
+    stats.errors++;
+
+    chunk_done();
+}
+
+void telemetry_get_stats(telemetry_stats_t* stats_out)
+{
+    *stats_out = stats;
+}
@@ -0,0 +1,182 @@
+/**
+ * @file telemetry.h
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ */
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include "stm32f0xx_hal.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "scheduler.h"
+
+/*
+ * Binary telemetry over USART2 (virtual COM port of the Nucleo), decoded by tools/telemetry.py.
+ *
+ * Records are queued in a ring buffer and sent by DMA, so sending never waits for the UART. If the ring buffer is
+ * full, the record is dropped (the host sees the gap in the sequence number).
+ *
+ * Record: type (u8), sequence (u8), time [ms] (u32), payload, CRC-8 (poly 0x07, init 0x00, over everything before)
+ * Frame:  COBS encoded record, terminated by 0x00
+ * Multi-byte values are little-endian. The payloads are described at telemetry_record_t.
+ */
+#define TELEMETRY_BUFFER_SIZE      256 // TX ring buffer, power of two [bytes]
+#define TELEMETRY_DMA_CHUNK_SIZE   64  // Max. bytes per DMA transfer, bounds telemetry_pause() [bytes]
+#define TELEMETRY_MAX_PAYLOAD      24  // [bytes]
+#define TELEMETRY_REPORT_PERIOD_MS 100 // Period of telemetry_report() in the game loop [ms]
+
+// Bytes a record takes in the ring buffer: header, CRC, COBS overhead and delimiter (payload <= TELEMETRY_MAX_PAYLOAD)
+#define TELEMETRY_FRAME_SIZE(payload) ((payload) + 9)
+
+/**
+ * @brief Record types (keep in sync with tools/telemetry.py)
+ */
+typedef enum {
+    TELEMETRY_RECORD_BOOT          = 0x01, // baud (u32)
+    TELEMETRY_RECORD_BAUD          = 0x02, // baud (u32), the following records use the new baud rate
+    TELEMETRY_RECORD_EVENT         = 0x03, // event (u8), argument (u16)
+    TELEMETRY_RECORD_ERROR         = 0x04, // source (u8), error code of the source module (u8)
+    TELEMETRY_RECORD_SCHEDULER     = 0x05, // updates, renders, late updates, overruns, dropped ticks (u32 each)
+    TELEMETRY_RECORD_PROFILE_SCOPE = 0x06, // scope (u8), count, min, avg, max [us] (u32 each)
+    TELEMETRY_RECORD_PROFILE_FRAME = 0x07, // count, min, avg, max, budget [us], over budget (u32 each)
+    TELEMETRY_RECORD_PROFILE_BUS   = 0x08, // bus (u8), transactions, bytes (u32 each)
+    TELEMETRY_RECORD_MATRIX        = 0x09, // devices X | Y << 4 (u8), offset (u8), max7219_fb_t bytes from offset on
+    TELEMETRY_RECORD_OLED          = 0x0A, // page (u8), first column (u8), PackBits compressed columns of the page
+    TELEMETRY_RECORD_REMOTE_INPUT  = 0x0B, // tag (u16), received, consumed [ms] (u32 each); time: frame pushed
+} telemetry_record_t;
+
+/**
+ * @brief Events (keep in sync with tools/telemetry.py)
+ */
+typedef enum {
+    TELEMETRY_EVENT_GAME_START = 0x01, // Argument: game id
+    TELEMETRY_EVENT_GAME_EXIT  = 0x02, // Argument: game id
+    TELEMETRY_EVENT_GAME_OVER  = 0x03, // Argument: score (snake), winner (tictactoe)
+    TELEMETRY_EVENT_STOP       = 0x04, // Entering stop mode
+    TELEMETRY_EVENT_WAKE_UP    = 0x05, // Back from stop mode
+} telemetry_event_t;
+
+/**
+ * @brief Error sources, the code is the error enum of the module (keep in sync with tools/telemetry.py)
+ */
+typedef enum {
+    TELEMETRY_SOURCE_CLOCK   = 0x01, // clock_error_t
+    TELEMETRY_SOURCE_MAX7219 = 0x02, // max7219_error_t
+    TELEMETRY_SOURCE_SSD1306 = 0x03, // 1: I2C error
+    TELEMETRY_SOURCE_STORAGE = 0x04, // storage_error_t
+} telemetry_source_t;
+
+/**
+ * @brief Telemetry statistics
+ */
+typedef struct {
+    uint32_t records; // Queued records
+    uint32_t dropped; // Records dropped because the ring buffer was full
+    uint32_t errors;  // Failed DMA starts and UART errors
+} telemetry_stats_t;
+
+/**
+ * @brief Initialize the telemetry and send the boot record (the UART must already be configured)
+ *
+ * @param[in] uart -- UART handle (DMA linked to the TX direction)
+ */
+void telemetry_init(UART_HandleTypeDef* uart);
+
+/**
+ * @brief Queue a record (may be called from interrupt context)
+ *
+ * @param[in] type    -- Record type
+ * @param[in] payload -- Payload
+ * @param[in] length  -- Payload length (<= TELEMETRY_MAX_PAYLOAD) [bytes]
+ *
+ * @return bool -- true: queued, false: dropped (not initialized, buffer full or payload too long)
+ */
+bool telemetry_send(telemetry_record_t type, const uint8_t* payload, uint8_t length);
+
+/**
+ * @brief Queue an event record
+ *
+ * @param[in] event    -- Event
+ * @param[in] argument -- Argument
+ */
+void telemetry_event(telemetry_event_t event, uint16_t argument);
+
+/**
+ * @brief Queue an error record
+ *
+ * @param[in] source -- Module which reported the error
+ * @param[in] code   -- Error code of the module
+ */
+void telemetry_error(telemetry_source_t source, uint8_t code);
+
+/**
+ * @brief Queue a baud rate announcement (call before the baud rate is changed, the queue has to be drained first)
+ *
+ * @param[in] baud -- New baud rate
+ */
+void telemetry_baud(uint32_t baud);
+
+/**
+ * @brief Queue the next record of the periodic report (scheduler stats, then the profiler stats if enabled)
+ *
+ * One record per call, so the report is spread over several calls instead of filling the ring buffer at once.
+ *
+ * @param[in] scheduler -- Scheduler statistics
+ */
+void telemetry_report(const scheduler_stats_t* scheduler);
+
+/**
+ * @brief Do not start further DMA transfers (e.g., before the UART is reconfigured), records are still queued
+ */
+void telemetry_pause(void);
+
+/**
+ * @brief Continue sending after telemetry_pause()
+ */
+void telemetry_resume(void);
+
+/**
+ * @brief Check if a DMA transfer is in progress
+ *
+ * @return bool -- true: busy
+ */
+bool telemetry_is_busy(void);
+
+/**
+ * @brief Get the free space of the ring buffer (see TELEMETRY_FRAME_SIZE())
+ *
+ * @return uint16_t -- [bytes] (0 if not initialized)
+ */
+uint16_t telemetry_get_free(void);
+
+/**
+ * @brief Check if everything queued has been sent
+ *
+ * @return bool -- true: empty
+ */
+bool telemetry_is_empty(void);
+
+/**
+ * @brief DMA transfer complete (call from HAL_UART_TxCpltCallback())
+ */
+void telemetry_uart_tx_complete(void);
+
+/**
+ * @brief DMA transfer failed (call from HAL_UART_ErrorCallback()), the chunk is skipped
+ */
+void telemetry_uart_error(void);
+
+/**
+ * @brief Get the statistics
+ *
+ * @param[out] stats -- Statistics
+ */
+void telemetry_get_stats(telemetry_stats_t* stats);
+
+#endif /* TELEMETRY_H_ */
@@ -8,15 +8,31 @@
 
 #include "tictactoe.h"
 
-#include <stdio.h>
+#include <stdlib.h>
 
 #include "app.h"
+#include "fmt.h"
 #include "max7219.h"
 #include "ssd1306.h"
+#include "storage.h"
+#include "telemetry.h"
+#include "tictactoe_ai.h"
+
+#define CPU_MOVE_DELAY_MS 400 // Let the player see the computer "thinking" [ms]
+
+#define CELL_AMOUNT         9
+#define LINE_AMOUNT         8
+#define BOARD_FULL          0x01FF
+#define CELL(col, row)      ((row) * 3 + (col))
+#define CELL_MASK(col, row) (1U << CELL(col, row))
+
+// 2x2 pixel shapes, bit (row * 2 + col)
+#define SHAPE_X 0x9 // Diagonal
+#define SHAPE_O 0xF // Block
 
 typedef struct {
-    int row;
-    int col;
+    uint8_t row;
+    uint8_t col;
 } cursor_t;
 
 typedef enum {
@@ -26,63 +42,189 @@ typedef enum {
     DRAW
 } field_t;
 
-// [COL][ROW]
-static field_t gamefield[3][3] = { NONE };
+typedef enum {
+    MODE_TWO_PLAYERS,
+    MODE_CPU_EASY,
+    MODE_CPU_MEDIUM,
+    MODE_CPU_PERFECT,
+    MODE_AMOUNT, // Keep at end!
+} game_mode_t;
+
+/* clang-format off */
+
+static const char* const MODE_NAMES[MODE_AMOUNT] = {
+    [MODE_TWO_PLAYERS] = "Mode: 2 Players",
+    [MODE_CPU_EASY]    = "Mode: CPU easy",
+    [MODE_CPU_MEDIUM]  = "Mode: CPU medium",
+    [MODE_CPU_PERFECT] = "Mode: CPU perfect",
+};
+
+static const tictactoe_ai_level_t MODE_AI_LEVELS[MODE_AMOUNT] = {
+    [MODE_CPU_EASY]    = TICTACTOE_AI_EASY,
+    [MODE_CPU_MEDIUM]  = TICTACTOE_AI_MEDIUM,
+    [MODE_CPU_PERFECT] = TICTACTOE_AI_PERFECT,
+};
+
+/* clang-format on */
+
+/**
+ * @brief Board as two bit masks, bit CELL(col, row) is set if the field is occupied by the player
+ */
+typedef struct {
+    uint16_t x;
+    uint16_t o;
+} board_t;
 
-static void    print_cursor(cursor_t cursor, field_t active_player);
-static void    show_grid(bool matrix[MAX7219_COLUMN_AMOUNT][MAX7219_ROW_AMOUNT]);
-static void    lcd_start(void);
-static void    convert_to_matrix(bool matrix[MAX7219_COLUMN_AMOUNT][MAX7219_ROW_AMOUNT]);
-static void    start_game(void);
-static void    player_move(field_t active_player);
-static field_t check_winner(void);
-static void    print_winner(field_t winner);
+typedef enum {
+    PHASE_SELECT_MODE,   // Mode selection (up/down), any other button starts
+    PHASE_PLAYER_MOVE,   // Human player moves the cursor
+    PHASE_COMPUTER_MOVE, // Computer "thinks" for CPU_MOVE_DELAY_MS
+    PHASE_GAME_OVER,     // Waiting for the user to leave
+} phase_t;
 
-void tictactoe(void)
+typedef struct {
+    board_t     board;
+    game_mode_t mode;
+    phase_t     phase;
+    field_t     active_player;
+    cursor_t    cursor;
+    uint32_t    elapsed_ms; // Time in the current phase [ms]
+} tictactoe_state_t;
+
+GAME_STATE_ASSERT(tictactoe_state_t);
+
+/* clang-format off */
+
+// Rows, columns and diagonals
+static const uint16_t LINES[LINE_AMOUNT] = {
+    0x007, 0x038, 0x1C0,
+    0x049, 0x092, 0x124,
+    0x111, 0x054,
+};
+
+// Top left pixel of every cell (the grid lines are at 2 and 5)
+static const struct {
+    uint8_t col;
+    uint8_t row;
+} CELL_PIXELS[CELL_AMOUNT] = {
+    { 0, 0 }, { 3, 0 }, { 6, 0 },
+    { 0, 3 }, { 3, 3 }, { 6, 3 },
+    { 0, 6 }, { 3, 6 }, { 6, 6 },
+};
+
+/* clang-format on */
+
+static void          clear_board(board_t* board);
+static bool          is_occupied(const board_t* board, uint8_t col, uint8_t row);
+static void          set_field(board_t* board, uint8_t col, uint8_t row, field_t player);
+static void          print_cursor(max7219_fb_t* matrix, cursor_t cursor, field_t active_player);
+static void          show_grid(max7219_fb_t* matrix);
+static void          lcd_start(void);
+static void          convert_to_matrix(const board_t* board, max7219_fb_t* matrix);
+static void          begin_turn(tictactoe_state_t* state);
+static void          end_turn(tictactoe_state_t* state);
+static void          player_move(tictactoe_state_t* state, button_t button);
+static void          computer_move(tictactoe_state_t* state);
+static void          select_mode(tictactoe_state_t* state, button_t button);
+static void          lcd_print_mode(game_mode_t mode);
+static field_t       check_winner(const board_t* board);
+static void          print_winner(field_t winner);
+static void          tictactoe_init(void* context);
+static game_status_t tictactoe_update(void* context, uint32_t dt_ms, const input_event_t* events, uint8_t event_amount);
+static void          tictactoe_render(const void* context, max7219_fb_t* fb);
+
+const game_t tictactoe_game = {
+    .name       = "TicTacToe",
+    .state_size = sizeof(tictactoe_state_t),
+    .init       = tictactoe_init,
+    .update     = tictactoe_update,
+    .render     = tictactoe_render,
+    .exit       = NULL,
+};
+
+static void tictactoe_init(void* context)
 {
-    field_t winner        = NONE;
-    field_t active_player = X;
+    tictactoe_state_t* state       = context;
+    uint32_t           stored_mode = MODE_TWO_PLAYERS;
 
-    show_grid(matrix);
-    max7219_set_matrix(&max7219, matrix);
     lcd_start();
 
-    while (app_get_user_input() == BUTTON_NONE) {
-        // Wait for user to start the game
-    }
+    storage_read(STORAGE_KEY_TICTACTOE_MODE, &stored_mode);
+
+    state->mode  = (stored_mode < MODE_AMOUNT) ? (game_mode_t)stored_mode : MODE_TWO_PLAYERS;
+    state->phase = PHASE_SELECT_MODE;
 
-    start_game();
-    convert_to_matrix(matrix);
-    max7219_set_matrix(&max7219, matrix);
+    lcd_print_mode(state->mode);
+}
+
+static game_status_t tictactoe_update(void* context, uint32_t dt_ms, const input_event_t* events, uint8_t event_amount)
+{
+    tictactoe_state_t* state = context;
 
-    do {
-        player_move(active_player);
+    state->elapsed_ms += dt_ms;
 
-        // Switch player
-        if (active_player == X) {
-            active_player = O;
-        } else {
-            active_player = X;
+    for (uint8_t i = 0; i < event_amount; i++) {
+        if (!events[i].pressed) {
+            continue;
         }
 
-        winner = check_winner();
-    } while (winner == NONE);
+        switch (state->phase) {
+        case PHASE_SELECT_MODE:
+            select_mode(state, events[i].button);
+            break;
+
+        case PHASE_PLAYER_MOVE:
+            player_move(state, events[i].button);
+            break;
 
-    print_winner(winner);
+        case PHASE_GAME_OVER:
+            return GAME_EXIT;
 
-    app_beep(BEEP_LONG_MS);
+        case PHASE_COMPUTER_MOVE:
+            break; // Not the turn of the player
+        }
+    }
 
-    while (app_get_user_input() == BUTTON_NONE) {
-        // Wait for user to start the game
+    if ((state->phase == PHASE_COMPUTER_MOVE) && (state->elapsed_ms >= CPU_MOVE_DELAY_MS)) {
+        computer_move(state);
     }
+
+    return GAME_CONTINUE;
 }
 
-static void clear_gamefield()
+static void tictactoe_render(const void* context, max7219_fb_t* fb)
 {
-    for (uint8_t col = 0; col < 3; col++) {
-        for (uint8_t row = 0; row < 3; row++) {
-            gamefield[col][row] = NONE;
-        }
+    const tictactoe_state_t* state = context;
+
+    if (state->phase == PHASE_SELECT_MODE) {
+        show_grid(fb);
+        return;
+    }
+
+    convert_to_matrix(&state->board, fb);
+
+    if (state->phase == PHASE_PLAYER_MOVE) {
+        print_cursor(fb, state->cursor, state->active_player);
+    }
+}
+
+static void clear_board(board_t* board)
+{
+    board->x = 0;
+    board->o = 0;
+}
+
+static bool is_occupied(const board_t* board, uint8_t col, uint8_t row)
+{
+    return ((board->x | board->o) & CELL_MASK(col, row)) != 0;
+}
+
+static void set_field(board_t* board, uint8_t col, uint8_t row, field_t player)
+{
+    if (player == X) {
+        board->x |= CELL_MASK(col, row);
+    } else {
+        board->o |= CELL_MASK(col, row);
     }
 }
 
@@ -95,190 +237,106 @@ static void lcd_start(void)
     SSD1306_UpdateScreen();
 }
 
-static void start_game(void)
+static void lcd_print_mode(game_mode_t mode)
 {
-    clear_gamefield();
+    SSD1306_GotoXY(0, APP_LCD_ROW_GAME_DYNAMIC_0);
+    SSD1306_Puts(APP_LCD_EMPTY_LINE, &Font_7x10, 1);
+    SSD1306_GotoXY(0, APP_LCD_ROW_GAME_DYNAMIC_0);
+    SSD1306_Puts(MODE_NAMES[mode], &Font_7x10, 1);
 }
 
-static void show_grid(bool matrix[MAX7219_COLUMN_AMOUNT][MAX7219_ROW_AMOUNT])
+/**
+ * @brief Let the user choose the mode (up/down), any other button starts the game
+ *
+ * @param state
+ * @param button
+ */
+static void select_mode(tictactoe_state_t* state, button_t button)
 {
-    app_matrix_clean(matrix);
-
-    // Set columns 2 and 5
-    for (int row = 0; row < MAX7219_ROW_AMOUNT; ++row) {
-        matrix[2][row] = true;
-        matrix[5][row] = true;
-    }
-
-    // Set rows 2 and 5
-    for (int col = 0; col < MAX7219_COLUMN_AMOUNT; ++col) {
-        matrix[col][2] = true;
-        matrix[col][5] = true;
+    if (button == BUTTON_DOWN) {
+        state->mode = (state->mode + 1) % MODE_AMOUNT;
+        lcd_print_mode(state->mode);
+        return;
     }
-}
 
-static void convert_to_matrix(bool matrix[MAX7219_COLUMN_AMOUNT][MAX7219_ROW_AMOUNT])
-{
-    app_matrix_clean(matrix);
-
-    // [COL][ROW]
-    if (gamefield[0][0] == O) {
-        matrix[0][0] = true;
-        matrix[0][1] = true;
-        matrix[1][0] = true;
-        matrix[1][1] = true;
-    } else if (gamefield[0][0] == X) {
-        matrix[0][0] = true;
-        matrix[1][1] = true;
+    if (button == BUTTON_UP) {
+        state->mode = (state->mode + MODE_AMOUNT - 1) % MODE_AMOUNT;
+        lcd_print_mode(state->mode);
+        return;
     }
 
-    if (gamefield[1][0] == O) {
-        matrix[3][0] = true;
-        matrix[4][0] = true;
-        matrix[3][1] = true;
-        matrix[4][1] = true;
-    } else if (gamefield[1][0] == X) {
-        matrix[3][0] = true;
-        matrix[4][1] = true;
-    }
+    storage_write(STORAGE_KEY_TICTACTOE_MODE, state->mode); // Only written if it changed
 
-    if (gamefield[2][0] == O) {
-        matrix[6][0] = true;
-        matrix[7][0] = true;
-        matrix[6][1] = true;
-        matrix[7][1] = true;
-    } else if (gamefield[2][0] == X) {
-        matrix[6][0] = true;
-        matrix[7][1] = true;
-    }
+    srand(HAL_GetTick());
 
-    if (gamefield[0][1] == O) {
-        matrix[0][3] = true;
-        matrix[0][4] = true;
-        matrix[1][3] = true;
-        matrix[1][4] = true;
-    } else if (gamefield[0][1] == X) {
-        matrix[0][3] = true;
-        matrix[1][4] = true;
-    }
+    // The human always plays X (starts), the computer O
+    clear_board(&state->board);
+    state->active_player = X;
 
-    if (gamefield[1][1] == O) {
-        matrix[3][3] = true;
-        matrix[3][4] = true;
-        matrix[4][3] = true;
-        matrix[4][4] = true;
-    } else if (gamefield[1][1] == X) {
-        matrix[3][3] = true;
-        matrix[4][4] = true;
-    }
+    begin_turn(state);
+}
 
-    if (gamefield[2][1] == O) {
-        matrix[6][3] = true;
-        matrix[6][4] = true;
-        matrix[7][3] = true;
-        matrix[7][4] = true;
-    } else if (gamefield[2][1] == X) {
-        matrix[6][3] = true;
-        matrix[7][4] = true;
-    }
+static void show_grid(max7219_fb_t* matrix)
+{
+    // Set columns 2 and 5
+    max7219_fb_set_column(matrix, 2);
+    max7219_fb_set_column(matrix, 5);
 
-    if (gamefield[0][2] == O) {
-        matrix[0][6] = true;
-        matrix[0][7] = true;
-        matrix[1][6] = true;
-        matrix[1][7] = true;
-    } else if (gamefield[0][2] == X) {
-        matrix[0][6] = true;
-        matrix[1][7] = true;
-    }
+    // Set rows 2 and 5
+    max7219_fb_set_row(matrix, 2);
+    max7219_fb_set_row(matrix, 5);
+}
 
-    if (gamefield[1][2] == O) {
-        matrix[3][6] = true;
-        matrix[3][7] = true;
-        matrix[4][6] = true;
-        matrix[4][7] = true;
-    } else if (gamefield[1][2] == X) {
-        matrix[3][6] = true;
-        matrix[4][7] = true;
-    }
+static void convert_to_matrix(const board_t* board, max7219_fb_t* matrix)
+{
+    for (uint8_t cell = 0; cell < CELL_AMOUNT; cell++) {
+        uint16_t cell_mask = 1U << cell;
+        uint8_t  shape     = 0;
+
+        if (board->o & cell_mask) {
+            shape = SHAPE_O;
+        } else if (board->x & cell_mask) {
+            shape = SHAPE_X;
+        }
 
-    if (gamefield[2][2] == O) {
-        matrix[6][6] = true;
-        matrix[6][7] = true;
-        matrix[7][6] = true;
-        matrix[7][7] = true;
-    } else if (gamefield[2][2] == X) {
-        matrix[6][6] = true;
-        matrix[7][7] = true;
+        for (uint8_t bit = 0; bit < 4; bit++) {
+            if (shape & (1U << bit)) {
+                max7219_fb_set_pixel(matrix, CELL_PIXELS[cell].col + (bit % 2), CELL_PIXELS[cell].row + (bit / 2));
+            }
+        }
     }
 }
 
-static void print_cursor(cursor_t cursor, field_t active_player)
+static void print_cursor(max7219_fb_t* matrix, cursor_t cursor, field_t active_player)
 {
-    convert_to_matrix(matrix);
-
-    matrix[cursor.col * 3][cursor.row * 3]         = true;
-    matrix[cursor.col * 3 + 1][cursor.row * 3 + 1] = true;
+    max7219_fb_set_pixel(matrix, cursor.col * 3, cursor.row * 3);
+    max7219_fb_set_pixel(matrix, cursor.col * 3 + 1, cursor.row * 3 + 1);
 
     if (active_player == X) {
-        matrix[cursor.col * 3][cursor.row * 3 + 1] = false;
-        matrix[cursor.col * 3 + 1][cursor.row * 3] = false;
+        max7219_fb_clear_pixel(matrix, cursor.col * 3, cursor.row * 3 + 1);
+        max7219_fb_clear_pixel(matrix, cursor.col * 3 + 1, cursor.row * 3);
     } else {
-        matrix[cursor.col * 3][cursor.row * 3 + 1] = true;
-        matrix[cursor.col * 3 + 1][cursor.row * 3] = true;
+        max7219_fb_set_pixel(matrix, cursor.col * 3, cursor.row * 3 + 1);
+        max7219_fb_set_pixel(matrix, cursor.col * 3 + 1, cursor.row * 3);
     }
-
-    max7219_set_matrix(&max7219, matrix);
 }
 
-// Analyze gamefield to check if/who is the winner
-static field_t check_winner(void)
+// Analyze the board to check if/who is the winner
+static field_t check_winner(const board_t* board)
 {
-    // Check columns
-    for (uint8_t i = 0; i < 3; i++) {
-        // Check column i
-        if ((gamefield[i][0] == gamefield[i][1]) && (gamefield[i][1] == gamefield[i][2])) {
-            // all fields in column i have the same value
-            if (gamefield[i][0] != NONE) {
-                return gamefield[i][0];
-            }
+    for (uint8_t i = 0; i < LINE_AMOUNT; i++) {
+        if ((board->x & LINES[i]) == LINES[i]) {
+            return X;
         }
-    }
-
-    // Check rows
-    for (uint8_t i = 0; i < 3; i++) {
-        // Check row i
-        if ((gamefield[0][i] == gamefield[1][i]) && (gamefield[1][i] == gamefield[2][i])) {
-            // all fields in row i have the same value
-            if (gamefield[0][i] != NONE) {
-                return gamefield[0][i];
-            }
-        }
-    }
-
-    // Check diagonal which goes from top left to bottom right
-    if ((gamefield[0][0] == gamefield[1][1]) && (gamefield[1][1] == gamefield[2][2])) {
-        // all fields in this diagonal have the same value
-        if (gamefield[0][0] != NONE) {
-            return gamefield[0][0];
-        }
-    }
 
-    // Check diagonal which goes from top right to bottom left
-    if ((gamefield[2][0] == gamefield[1][1]) && (gamefield[1][1] == gamefield[0][2])) {
-        // all fields in this diagonal have the same value
-        if (gamefield[2][0] != NONE) {
-            return gamefield[2][0];
+        if ((board->o & LINES[i]) == LINES[i]) {
+            return O;
         }
     }
 
     // Check if game needs to continue
-    for (uint8_t col = 0; col < 3; col++) {
-        for (uint8_t row = 0; row < 3; row++) {
-            if (gamefield[col][row] == NONE) {
-                return NONE;
-            }
-        }
+    if ((board->x | board->o) != BOARD_FULL) {
+        return NONE;
     }
 
     return DRAW;
@@ -286,132 +344,147 @@ static field_t check_winner(void)
 
 static void print_winner(field_t winner)
 {
-    char string[20] = "";
+    char  string[20];
+    fmt_t fmt;
+
+    fmt_init(&fmt, string, sizeof(string));
+    fmt_str(&fmt, "Winner: ");
 
     switch (winner) {
     case O:
-        sprintf(string, "Winner: O");
+        fmt_str(&fmt, "O");
         break;
     case X:
-        sprintf(string, "Winner: X");
+        fmt_str(&fmt, "X");
         break;
     case DRAW:
-        sprintf(string, "Winner: DRAW");
+        fmt_str(&fmt, "DRAW");
         break;
 
     default:
         break; // Not reachable
     }
 
+    SSD1306_GotoXY(0, APP_LCD_ROW_GAME_DYNAMIC_0);
+    SSD1306_Puts(APP_LCD_EMPTY_LINE, &Font_7x10, 1); // Mode
     SSD1306_GotoXY(0, APP_LCD_ROW_GAME_DYNAMIC_0);
     SSD1306_Puts(string, &Font_7x10, 1);
-    SSD1306_UpdateScreen();
 }
 
-static void player_move(field_t active_player)
+static void begin_turn(tictactoe_state_t* state)
 {
-    button_t button = BUTTON_NONE;
+    state->elapsed_ms = 0;
 
-    // init curser
-    cursor_t cursor = {
-        .row = 0,
-        .col = 0,
-    };
+    if ((state->mode != MODE_TWO_PLAYERS) && (state->active_player == O)) {
+        state->phase = PHASE_COMPUTER_MOVE;
+        return;
+    }
 
-    // find first empty field
-    while (gamefield[cursor.col][cursor.row] != NONE) {
-        ++cursor.col;
+    state->phase = PHASE_PLAYER_MOVE;
 
-        if (cursor.col >= 3) {
-            cursor.col = 0;
-            ++cursor.row;
+    // init cursor on the first empty field
+    state->cursor.col = 0;
+    state->cursor.row = 0;
 
-            if (cursor.row >= 3) {
-                break;
-            }
+    for (uint8_t cell = 0; cell < CELL_AMOUNT; cell++) {
+        if (!is_occupied(&state->board, cell % 3, cell / 3)) {
+            state->cursor.col = cell % 3;
+            state->cursor.row = cell / 3;
+            break;
         }
     }
+}
 
-    bool already_occupied = false;
-
-    // Let user decide which field he wants to choose
-    do {
-        button = app_get_user_input();
+static void end_turn(tictactoe_state_t* state)
+{
+    field_t winner = check_winner(&state->board);
 
-        switch (button) {
-        case BUTTON_LEFT:
-            if (cursor.col == 0) {
-                break;
-            }
+    if (winner != NONE) {
+        state->phase = PHASE_GAME_OVER;
 
-            if (gamefield[cursor.col - 1][cursor.row] != NONE) {
-                already_occupied = true;
-            } else {
-                already_occupied = false;
-            }
+        print_winner(winner);
+        telemetry_event(TELEMETRY_EVENT_GAME_OVER, winner);
+        app_beep(BEEP_LONG_MS);
+        return;
+    }
 
-            --cursor.col;
+    // Switch player
+    if (state->active_player == X) {
+        state->active_player = O;
+    } else {
+        state->active_player = X;
+    }
 
-            break;
+    begin_turn(state);
+}
 
-        case BUTTON_RIGHT:
-            if (cursor.col == 2) {
-                break;
-            }
+static void player_move(tictactoe_state_t* state, button_t button)
+{
+    cursor_t* cursor = &state->cursor;
 
-            if (gamefield[cursor.col + 1][cursor.row] != NONE) {
-                already_occupied = true;
-            } else {
-                already_occupied = false;
-            }
+    switch (button) {
+    case BUTTON_LEFT:
+        if (cursor->col > 0) {
+            --cursor->col;
+        }
 
-            ++cursor.col;
+        break;
 
-            break;
+    case BUTTON_RIGHT:
+        if (cursor->col < 2) {
+            ++cursor->col;
+        }
 
-        case BUTTON_UP:
-            if (cursor.row == 0) {
-                break;
-            }
+        break;
 
-            if (gamefield[cursor.col][cursor.row - 1] != NONE) {
-                already_occupied = true;
-            } else {
-                already_occupied = false;
-            }
+    case BUTTON_UP:
+        if (cursor->row > 0) {
+            --cursor->row;
+        }
 
-            --cursor.row;
+        break;
 
-            break;
+    case BUTTON_DOWN:
+        if (cursor->row < 2) {
+            ++cursor->row;
+        }
 
-        case BUTTON_DOWN:
-            if (cursor.row == 2) {
-                break;
-            }
+        break;
 
-            if (gamefield[cursor.col][cursor.row + 1] != NONE) {
-                already_occupied = true;
-            } else {
-                already_occupied = false;
-            }
+    case BUTTON_CENTER:
+        // Let user decide which field he wants to choose (only empty fields)
+        if (!is_occupied(&state->board, cursor->col, cursor->row)) {
+            set_field(&state->board, cursor->col, cursor->row, state->active_player);
+            end_turn(state);
+        }
 
-            ++cursor.row;
+        break;
 
-            break;
+    case BUTTON_NONE:
+        break; // Nothing to do
+    }
+}
 
-        case BUTTON_CENTER:
-        case BUTTON_NONE:
-            break; // Nothing to do
+static void computer_move(tictactoe_state_t* state)
+{
+    uint8_t cells[TICTACTOE_AI_CELL_AMOUNT];
+
+    // Same cell order, field_t NONE/X/O matches the AI encoding
+    for (uint8_t cell = 0; cell < CELL_AMOUNT; cell++) {
+        if (state->board.x & (1U << cell)) {
+            cells[cell] = X;
+        } else if (state->board.o & (1U << cell)) {
+            cells[cell] = O;
+        } else {
+            cells[cell] = NONE;
         }
+    }
 
-        print_cursor(cursor, active_player);
-
-    } while ((button != BUTTON_CENTER) || (already_occupied));
+    uint8_t cell = tictactoe_ai_move(cells, MODE_AI_LEVELS[state->mode]);
 
-    // Insert user choice into gamefield
-    gamefield[cursor.col][cursor.row] = active_player;
+    if (cell != TICTACTOE_AI_NO_MOVE) {
+        set_field(&state->board, cell % 3, cell / 3, state->active_player);
+    }
 
-    // Print
-    convert_to_matrix(matrix);
-    max7219_set_matrix(&max7219, matrix);
+    end_turn(state);
 }
@@ -9,6 +9,8 @@
 #ifndef TICTACTOE_H_
 #define TICTACTOE_H_
 
-void tictactoe(void);
+#include "game.h"
+
+extern const game_t tictactoe_game;
 
 #endif /* TICTACTOE_H_ */
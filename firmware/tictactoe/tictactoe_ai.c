@@ -0,0 +1,125 @@
+/**
+ * @file tictactoe_ai.c
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ */
+
+#include "tictactoe_ai.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "tictactoe_ai_table.h"
+
+/* clang-format off */
+
+// canonical[i] = board[SYMMETRIES[s][i]] (identity, rotations, reflections), same order as in the generator
+static const uint8_t SYMMETRIES[8][TICTACTOE_AI_CELL_AMOUNT] = {
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8 },
+    { 6, 3, 0, 7, 4, 1, 8, 5, 2 },
+    { 8, 7, 6, 5, 4, 3, 2, 1, 0 },
+    { 2, 5, 8, 1, 4, 7, 0, 3, 6 },
+    { 2, 1, 0, 5, 4, 3, 8, 7, 6 },
+    { 6, 7, 8, 3, 4, 5, 0, 1, 2 },
+    { 0, 3, 6, 1, 4, 7, 2, 5, 8 },
+    { 8, 5, 2, 7, 4, 1, 6, 3, 0 },
+};
+
+static const uint8_t RANDOM_MOVE_PERCENT[TICTACTOE_AI_LEVEL_AMOUNT] = {
+    [TICTACTOE_AI_EASY]    = 50,
+    [TICTACTOE_AI_MEDIUM]  = 20,
+    [TICTACTOE_AI_PERFECT] = 0,
+};
+
+/* clang-format on */
+
+static uint16_t board_key(const uint8_t board[TICTACTOE_AI_CELL_AMOUNT], const uint8_t symmetry[TICTACTOE_AI_CELL_AMOUNT])
+{
+    uint16_t key = 0;
+
+    // Horner scheme, cell 8 is the most significant digit
+    for (uint8_t i = TICTACTOE_AI_CELL_AMOUNT; i > 0; i--) {
+        key = key * 3 + board[symmetry[i - 1]];
+    }
+
+    return key;
+}
+
+static bool table_lookup(uint16_t key, uint8_t* move)
+{
+    uint16_t low  = 0;
+    uint16_t high = TICTACTOE_AI_TABLE_SIZE;
+
+    while (low < high) {
+        uint16_t middle = (low + high) / 2;
+
+        if (TICTACTOE_AI_KEYS[middle] < key) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    if ((low >= TICTACTOE_AI_TABLE_SIZE) || (TICTACTOE_AI_KEYS[low] != key)) {
+        return false;
+    }
+
+    *move = (TICTACTOE_AI_MOVES[low / 2] >> ((low % 2) * 4)) & 0x0F;
+
+    return true;
+}
+
+static uint8_t random_move(const uint8_t board[TICTACTOE_AI_CELL_AMOUNT], uint8_t empty_amount)
+{
+    uint8_t selected = rand() % empty_amount;
+
+    for (uint8_t cell = 0; cell < TICTACTOE_AI_CELL_AMOUNT; cell++) {
+        if ((board[cell] == 0) && (selected-- == 0)) {
+            return cell;
+        }
+    }
+
+    return TICTACTOE_AI_NO_MOVE; // Not reachable
+}
+
+uint8_t tictactoe_ai_move(const uint8_t board[TICTACTOE_AI_CELL_AMOUNT], tictactoe_ai_level_t level)
+{
+    uint8_t empty_amount = 0;
+
+    for (uint8_t cell = 0; cell < TICTACTOE_AI_CELL_AMOUNT; cell++) {
+        if (board[cell] == 0) {
+            empty_amount++;
+        }
+    }
+
+    if (empty_amount == 0) {
+        return TICTACTOE_AI_NO_MOVE;
+    }
+
+    if ((level < TICTACTOE_AI_LEVEL_AMOUNT) && ((uint8_t)(rand() % 100) < RANDOM_MOVE_PERCENT[level])) {
+        return random_move(board, empty_amount);
+    }
+
+    // Canonical position: smallest key of all symmetries
+    uint8_t  symmetry = 0;
+    uint16_t key      = board_key(board, SYMMETRIES[0]);
+
+    for (uint8_t s = 1; s < 8; s++) {
+        uint16_t symmetric_key = board_key(board, SYMMETRIES[s]);
+
+        if (symmetric_key < key) {
+            key      = symmetric_key;
+            symmetry = s;
+        }
+    }
+
+    uint8_t move;
+
+    if (!table_lookup(key, &move)) {
+        return random_move(board, empty_amount); // Position not reachable in a regular game
+    }
+
+    return SYMMETRIES[symmetry][move]; // Back to the orientation of the board
+}
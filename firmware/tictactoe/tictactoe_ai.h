@@ -0,0 +1,38 @@
+/**
+ * @file tictactoe_ai.h
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ */
+
+#ifndef TICTACTOE_AI_H_
+#define TICTACTOE_AI_H_
+
+#include <stdint.h>
+
+#define TICTACTOE_AI_CELL_AMOUNT 9
+#define TICTACTOE_AI_NO_MOVE     0xFF
+
+/**
+ * @brief Difficulty: probability of a random move instead of the optimal one
+ */
+typedef enum {
+    TICTACTOE_AI_EASY,    // 50 % random moves
+    TICTACTOE_AI_MEDIUM,  // 20 % random moves
+    TICTACTOE_AI_PERFECT, // Never loses
+    TICTACTOE_AI_LEVEL_AMOUNT, // Keep at end!
+} tictactoe_ai_level_t;
+
+/**
+ * @brief Get the move of the computer opponent (table lookup, no search)
+ *
+ * @param[in] board -- Cells (index = row * 3 + col) with 0: empty, 1: X, 2: O; the player to move is derived from the
+ *                     amount of X and O (X moves first)
+ * @param[in] level -- Difficulty
+ *
+ * @return uint8_t -- Cell to play, TICTACTOE_AI_NO_MOVE if the board is full
+ */
+uint8_t tictactoe_ai_move(const uint8_t board[TICTACTOE_AI_CELL_AMOUNT], tictactoe_ai_level_t level);
+
+#endif /* TICTACTOE_AI_H_ */
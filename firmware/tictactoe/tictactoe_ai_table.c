@@ -0,0 +1,92 @@
+/**
+ * @file tictactoe_ai_table.c
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ * GENERATED by tools/gen_tictactoe_table.py -- do not edit!
+ *
+ * 627 canonical positions, 1568 bytes
+ */
+
+#include "tictactoe_ai_table.h"
+
+const uint16_t TICTACTOE_AI_TABLE_SIZE = 627;
+
+const uint16_t TICTACTOE_AI_KEYS[627] = {
+        0,     1,     3,     5,     7,    11,    14,    16,    32,    33,    34,    38,
+       42,    44,    45,    46,    48,    50,    52,    63,    64,    66,    68,    70,
+       76,    81,    83,    86,    87,    88,    92,    98,   104,   114,   116,   125,
+      126,   128,   131,   132,   133,   142,   144,   146,   149,   150,   151,   154,
+      156,   157,   163,   165,   166,   172,   176,   178,   192,   194,   196,   198,
+      200,   203,   204,   205,   208,   210,   211,   226,   228,   272,   276,   278,
+      287,   290,   293,   297,   298,   300,   302,   304,   306,   308,   311,   312,
+      313,   316,   318,   319,   378,   380,   383,   384,   385,   389,   393,   395,
+      396,   397,   399,   401,   403,   432,   434,   437,   438,   439,   443,   449,
+      455,   460,   462,   463,   468,   469,   471,   473,   475,   481,   544,   550,
+      622,   624,   625,   631,   635,   637,   740,   744,   746,   747,   748,   750,
+      752,   754,   773,   774,   776,   779,   780,   798,   799,   802,   804,   805,
+      828,   830,   833,   834,   835,   857,   861,   882,   883,   885,   887,   889,
+      900,   902,   905,   906,   907,   910,   912,   913,   933,   935,   936,   939,
+      941,   961,   967,   974,   978,   980,   989,   992,   995,   996,   997,  1007,
+     1019,  1023,  1028,  1031,  1032,  1033,  1037,  1041,  1043,  1044,  1045,  1047,
+     1049,  1051,  1061,  1073,  1077,  1109,  1113,  1115,  1125,  1127,  1130,  1131,
+     1132,  1136,  1139,  1140,  1141,  1145,  1149,  1151,  1153,  1155,  1157,  1159,
+     1163,  1167,  1169,  1178,  1179,  1181,  1184,  1185,  1189,  1191,  1193,  1195,
+     1197,  1199,  1202,  1203,  1204,  1207,  1209,  1210,  1216,  1220,  1222,  1226,
+     1229,  1230,  1231,  1234,  1237,  1244,  1247,  1248,  1253,  1257,  1259,  1260,
+     1263,  1265,  1270,  1272,  1273,  1278,  1279,  1281,  1283,  1285,  1291,  1298,
+     1301,  1302,  1303,  1315,  1319,  1321,  1325,  1329,  1331,  1341,  1343,  1346,
+     1347,  1351,  1353,  1355,  1357,  1369,  1371,  1372,  1378,  1381,  1387,  1391,
+     1393,  1399,  1407,  1409,  1415,  1418,  1419,  1425,  1480,  1506,  1507,  1558,
+     1560,  1561,  1587,  1589,  1591,  1704,  1706,  1708,  1712,  1715,  1716,  1717,
+     1720,  1722,  1723,  1730,  1733,  1734,  1735,  1739,  1743,  1745,  1746,  1747,
+     1749,  1751,  1753,  1758,  1759,  1765,  1767,  1771,  1777,  1784,  1787,  1788,
+     1789,  1793,  1797,  1799,  1801,  1803,  1805,  1807,  1839,  1843,  1851,  1852,
+     1855,  1857,  1858,  1866,  1867,  1873,  1875,  1877,  1879,  1893,  1895,  1897,
+     1901,  1904,  1905,  1906,  1921,  1927,  1929,  1948,  1954,  1974,  1975,  1981,
+     1983,  1985,  1987,  1993,  2029,  2035,  2039,  2041,  2047,  2055,  2057,  2059,
+     2063,  2066,  2067,  2068,  2071,  2073,  2074,  2083,  2089,  2091,  2137,  2143,
+     2145,  2465,  2477,  2490,  2491,  2495,  2499,  2501,  2503,  2505,  2507,  2509,
+     2571,  2573,  2582,  2585,  2589,  2590,  2625,  2627,  2636,  2639,  2642,  2653,
+     2657,  2660,  2661,  2662,  2665,  2667,  2668,  2730,  2731,  2737,  2741,  2743,
+     2815,  2819,  2824,  3179,  3230,  3233,  3236,  3237,  3238,  3314,  3318,  3338,
+     3341,  3344,  3346,  3368,  3372,  3390,  3392,  3394,  3396,  3398,  3400,  3407,
+     3409,  3413,  3419,  3421,  3425,  3427,  3435,  3437,  3446,  3449,  3452,  3453,
+     3461,  3463,  3467,  3470,  3471,  3472,  3475,  3477,  3478,  3491,  3503,  3508,
+     3518,  3530,  3534,  3543,  3544,  3556,  3562,  3569,  3571,  3575,  3578,  3580,
+     3583,  3586,  3596,  3597,  3602,  3606,  3608,  3614,  3907,  3911,  3913,  3938,
+     3939,  3940,  3989,  3994,  4048,  4141,  4145,  4147,  4153,  4163,  4165,  4169,
+     4172,  4173,  4174,  4177,  4180,  4195,  4219,  4223,  4228,  4231,  4245,  4246,
+     4250,  4254,  4256,  4258,  4264,  4276,  4282,  4303,  4330,  4334,  4336,  5005,
+     5599,  5603,  5605,  5611,  5630,  5689,  5692,  5720,  5746,  5761,  5792,  6448,
+     7307,  7310,  7313,  7337,  7361,  7363,  7367,  7369,  7391,  7445,  7448,  7463,
+     7469,  7475,  7496,  7499,  7502,  7522,  7525,  7528,  7607,  7610,  7612,  7688,
+     7742,  7768,  7772,  7774,  7841,  7844,  7846,  7934,  8038,  8041,  8069,  8071,
+     8123,  8150,  8285,  8287,  8309,  8312,  8314,  8335,  8338,  8363,  8366,  8519,
+     8521,  8543,  8546,  8548,  8554,  8597,  8600,  8624,  8630,  8636,  8708,  8710,
+    10469, 10472, 10528, 10550, 10706, 10736, 10742, 10744, 10762, 10768, 10790, 10820,
+    10868, 12220, 17060,
+};
+
+const uint8_t TICTACTOE_AI_MOVES[314] = {
+    0x40, 0x30, 0x54, 0x43, 0x44, 0x44, 0x74, 0x40, 0x48, 0x04, 0x01, 0x44, 0x04, 0x71, 0x20, 0x36,
+    0x03, 0x52, 0x15, 0x05, 0x25, 0x60, 0x06, 0x16, 0x50, 0x01, 0x12, 0x78, 0x80, 0x06, 0x88, 0x77,
+    0x66, 0x56, 0x45, 0x24, 0x44, 0x04, 0x22, 0x86, 0x68, 0x48, 0x18, 0x40, 0x60, 0x26, 0x68, 0x60,
+    0x80, 0x77, 0x18, 0x22, 0x60, 0x88, 0x26, 0x22, 0x10, 0x80, 0x68, 0x44, 0x01, 0x72, 0x76, 0x48,
+    0x05, 0x48, 0x47, 0x04, 0x88, 0x50, 0x84, 0x57, 0x10, 0x07, 0x53, 0x70, 0x78, 0x87, 0x81, 0x73,
+    0x73, 0x30, 0x50, 0x07, 0x58, 0x25, 0x24, 0x14, 0x04, 0x48, 0x04, 0x21, 0x42, 0x44, 0x07, 0x44,
+    0x87, 0x12, 0x20, 0x22, 0x10, 0x07, 0x88, 0x78, 0x87, 0x88, 0x03, 0x78, 0x01, 0x72, 0x10, 0x08,
+    0x21, 0x78, 0x88, 0x88, 0x17, 0x70, 0x44, 0x72, 0x04, 0x83, 0x23, 0x28, 0x74, 0x87, 0x88, 0x44,
+    0x42, 0x44, 0x44, 0x14, 0x02, 0x82, 0x37, 0x02, 0x02, 0x81, 0x20, 0x88, 0x87, 0x88, 0x33, 0x33,
+    0x33, 0x80, 0x88, 0x87, 0x44, 0x15, 0x50, 0x88, 0x07, 0x44, 0x83, 0x83, 0x44, 0x27, 0x24, 0x44,
+    0x74, 0x44, 0x44, 0x04, 0x14, 0x80, 0x34, 0x03, 0x33, 0x30, 0x07, 0x73, 0x87, 0x88, 0x01, 0x27,
+    0x12, 0x80, 0x08, 0x22, 0x88, 0x78, 0x72, 0x40, 0x24, 0x12, 0x40, 0x44, 0x12, 0x87, 0x77, 0x87,
+    0x71, 0x80, 0x88, 0x28, 0x07, 0x12, 0x40, 0x84, 0x88, 0x68, 0x44, 0x86, 0x20, 0x16, 0x80, 0x20,
+    0x18, 0x86, 0x68, 0x88, 0x66, 0x46, 0x44, 0x44, 0x12, 0x86, 0x14, 0x84, 0x18, 0x80, 0x88, 0x13,
+    0x80, 0x88, 0x88, 0x28, 0x32, 0x83, 0x34, 0x22, 0x84, 0x08, 0x44, 0x44, 0x44, 0x48, 0x24, 0x81,
+    0x12, 0x00, 0x82, 0x88, 0x83, 0x33, 0x33, 0x28, 0x08, 0x88, 0x44, 0x44, 0x44, 0x31, 0x18, 0x34,
+    0x44, 0x12, 0x04, 0x14, 0x44, 0x18, 0x18, 0x80, 0x01, 0x88, 0x18, 0x18, 0x81, 0x18, 0x41, 0x83,
+    0x34, 0x88, 0x18, 0x88, 0x73, 0x17, 0x44, 0x57, 0x71, 0x17, 0x75, 0x77, 0x57, 0x57, 0x77, 0x14,
+    0x71, 0x77, 0x44, 0x74, 0x44, 0x44, 0x53, 0x43, 0x44, 0x44, 0x34, 0x33, 0x14, 0x44, 0x34, 0x13,
+    0x77, 0x77, 0x31, 0x14, 0x43, 0x44, 0x44, 0x13, 0x43, 0x04,
+};
@@ -0,0 +1,24 @@
+/**
+ * @file tictactoe_ai_table.h
+ * @author Timon Burkard (timon.burkard@gwf.ch)
+ *
+ * @copyright Copyright (c) 2025 GWF AG
+ *
+ */
+
+#ifndef TICTACTOE_AI_TABLE_H_
+#define TICTACTOE_AI_TABLE_H_
+
+#include <stdint.h>
+
+/*
+ * Perfect-play move table, generated by tools/gen_tictactoe_table.py (tictactoe_ai_table.c).
+ *
+ * TICTACTOE_AI_KEYS:  sorted keys of the canonical (smallest key of all symmetries) undecided positions
+ * TICTACTOE_AI_MOVES: best move (cell 0..8) of the position with the same index, two per byte (low nibble first)
+ */
+extern const uint16_t TICTACTOE_AI_TABLE_SIZE;
+extern const uint16_t TICTACTOE_AI_KEYS[];
+extern const uint8_t  TICTACTOE_AI_MOVES[];
+
+#endif /* TICTACTOE_AI_TABLE_H_ */
@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""
+Generates tictactoe/tictactoe_ai_table.c, the perfect-play move table of the TicTacToe computer opponent.
+
+All positions reachable from the empty board (X moves first) which are not decided yet are solved with negamax. The
+positions are reduced to one canonical representative per symmetry class (smallest key of the 8 rotations and
+reflections), so the firmware only has to store a few hundred entries.
+
+Board encoding (must match tictactoe_ai.c):
+    cell  = row * 3 + col
+    value = 0 (empty), 1 (X), 2 (O)
+    key   = sum(value[cell] * 3^cell)
+
+Usage: python3 tools/gen_tictactoe_table.py > tictactoe/tictactoe_ai_table.c
+"""
+
+import sys
+from functools import lru_cache
+
+LINES = [(0, 1, 2), (3, 4, 5), (6, 7, 8), (0, 3, 6), (1, 4, 7), (2, 5, 8), (0, 4, 8), (2, 4, 6)]
+
+# canonical[i] = board[SYMMETRIES[s][i]] (identity, rotations, reflections); must match tictactoe_ai.c
+SYMMETRIES = [
+    (0, 1, 2, 3, 4, 5, 6, 7, 8),
+    (6, 3, 0, 7, 4, 1, 8, 5, 2),
+    (8, 7, 6, 5, 4, 3, 2, 1, 0),
+    (2, 5, 8, 1, 4, 7, 0, 3, 6),
+    (2, 1, 0, 5, 4, 3, 8, 7, 6),
+    (6, 7, 8, 3, 4, 5, 0, 1, 2),
+    (0, 3, 6, 1, 4, 7, 2, 5, 8),
+    (8, 5, 2, 7, 4, 1, 6, 3, 0),
+]
+
+
+def key(board):
+    return sum(value * 3**cell for cell, value in enumerate(board))
+
+
+def canonical(board):
+    return min((tuple(board[i] for i in sym) for sym in SYMMETRIES), key=key)
+
+
+def winner(board):
+    for a, b, c in LINES:
+        if board[a] != 0 and board[a] == board[b] == board[c]:
+            return board[a]
+    return 0
+
+
+def to_move(board):
+    return 1 if board.count(1) == board.count(2) else 2
+
+
+@lru_cache(maxsize=None)
+def negamax(board):
+    """Score for the player to move: > 0 win (sooner is higher), 0 draw, < 0 loss (later is higher)."""
+    if winner(board) != 0:
+        return -(10 - board.count(0))  # The previous move won
+    if 0 not in board:
+        return 0
+    player = to_move(board)
+    return max(-negamax(board[:cell] + (player,) + board[cell + 1:]) for cell in range(9) if board[cell] == 0)
+
+
+def best_move(board):
+    player = to_move(board)
+    moves = [cell for cell in range(9) if board[cell] == 0]
+    # Lowest cell index among the best moves, so the table is deterministic
+    return max(moves, key=lambda cell: (-negamax(board[:cell] + (player,) + board[cell + 1:]), -cell))
+
+
+def reachable():
+    positions = set()
+    stack = [(0,) * 9]
+    while stack:
+        board = stack.pop()
+        if board in positions:
+            continue
+        positions.add(board)
+        if winner(board) != 0 or 0 not in board:
+            continue
+        player = to_move(board)
+        for cell in range(9):
+            if board[cell] == 0:
+                stack.append(board[:cell] + (player,) + board[cell + 1:])
+    return positions
+
+
+def main():
+    table = {}
+    for board in reachable():
+        if winner(board) != 0 or 0 not in board:
+            continue
+        canon = canonical(board)
+        table[key(canon)] = best_move(canon)
+
+    keys = sorted(table)
+    moves = [table[k] for k in keys]
+    if len(moves) % 2:
+        moves.append(0)
+    packed = [moves[i] | (moves[i + 1] << 4) for i in range(0, len(moves), 2)]
+
+    out = sys.stdout
+    out.write("/**\n")
+    out.write(" * @file tictactoe_ai_table.c\n")
+    out.write(" *\n")
+    out.write(" * @copyright Copyright (c) 2025 GWF AG\n")
+    out.write(" *\n")
+    out.write(" * GENERATED by tools/gen_tictactoe_table.py -- do not edit!\n")
+    out.write(" *\n")
+    out.write(" * %d canonical positions, %d bytes\n" % (len(keys), 2 * len(keys) + len(packed)))
+    out.write(" */\n\n")
+    out.write('#include "tictactoe_ai_table.h"\n\n')
+    out.write("const uint16_t TICTACTOE_AI_TABLE_SIZE = %d;\n\n" % len(keys))
+    out.write("const uint16_t TICTACTOE_AI_KEYS[%d] = {\n" % len(keys))
+    for i in range(0, len(keys), 12):
+        out.write("    " + ", ".join("%5d" % k for k in keys[i:i + 12]) + ",\n")
+    out.write("};\n\n")
+    out.write("const uint8_t TICTACTOE_AI_MOVES[%d] = {\n" % len(packed))
+    for i in range(0, len(packed), 16):
+        out.write("    " + ", ".join("0x%02X" % m for m in packed[i:i + 16]) + ",\n")
+    out.write("};\n")
+
+
+if __name__ == "__main__":
+    main()
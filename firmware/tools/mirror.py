@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+"""
+Shows the matrix and the OLED of the firmware in a terminal, reconstructed from the mirror records of the telemetry.
+
+The firmware has to be built with MIRROR_ENABLED=1 (mirror/mirror.h). It only sends changes and a full refresh every
+few seconds, so the viewer can be started at any time. The other telemetry records are shown below the displays.
+
+Usage:
+    python3 tools/mirror.py --port /dev/ttyACM0
+    python3 tools/mirror.py --file uart.bin        (shows the last state)
+"""
+
+import argparse
+import collections
+import sys
+import time
+
+import telemetry
+
+OLED_WIDTH = 128  # Must match ssd1306.h
+OLED_PAGES = 8
+ROW_BITS = [6, 5, 4, 3, 2, 1, 0, 7]  # Segment bit of a row within a device (ROW_TO_SEGMENT in max7219.c)
+LOG_LINES = 8
+FRAME_PERIOD_S = 0.05
+
+
+class Log:
+    """Keeps the last lines written by the decoder"""
+
+    def __init__(self, amount):
+        self.lines = collections.deque(maxlen=amount)
+        self.partial = ""
+
+    def write(self, text):
+        *lines, self.partial = (self.partial + text).split("\n")
+        self.lines.extend(lines)
+
+    def flush(self):
+        pass
+
+
+class Mirror(telemetry.Decoder):
+    def __init__(self, log):
+        super().__init__(log)
+        self.reset()
+
+    def reset(self):
+        self.devices = (1, 1)
+        self.matrix = bytearray(8)
+        self.oled = bytearray(OLED_WIDTH * OLED_PAGES)
+        self.changed = True
+
+    def record(self, kind, sequence, time_ms, payload):
+        try:
+            if kind == 0x09:
+                self.update_matrix(payload)
+                return None
+            if kind == 0x0A:
+                self.update_oled(payload)
+                return None
+        except (IndexError, telemetry.struct.error):
+            self.output.write(f"# invalid mirror record {kind:#04x} {payload.hex()}\n")
+            return None
+
+        if kind == 0x01:
+            self.reset()
+
+        return super().record(kind, sequence, time_ms, payload)
+
+    def update_matrix(self, payload):
+        geometry, offset = payload[0], payload[1]
+        devices = (geometry & 0x0F, geometry >> 4)
+
+        if devices != self.devices:
+            self.devices = devices
+            self.matrix = bytearray(devices[0] * devices[1] * 8)
+
+        data = payload[2:]
+
+        if offset + len(data) > len(self.matrix):
+            raise IndexError("matrix offset")
+
+        self.matrix[offset : offset + len(data)] = data
+        self.changed = True
+
+    def update_oled(self, payload):
+        page, column = payload[0], payload[1]
+        data = telemetry.packbits_decode(payload[2:])
+
+        if page >= OLED_PAGES or column + len(data) > OLED_WIDTH:
+            raise IndexError("OLED window")
+
+        start = page * OLED_WIDTH + column
+        self.oled[start : start + len(data)] = data
+        self.changed = True
+
+    def matrix_pixel(self, col, row):
+        columns = self.devices[0] * 8
+
+        return (self.matrix[(row // 8) * columns + col] >> ROW_BITS[row % 8]) & 1
+
+    def oled_pixel(self, x, y):
+        return (self.oled[(y // 8) * OLED_WIDTH + x] >> (y % 8)) & 1
+
+    def render(self):
+        lines = []
+
+        for row in range(self.devices[1] * 8):
+            pixels = (self.matrix_pixel(col, row) for col in range(self.devices[0] * 8))
+            lines.append(" ".join("●" if pixel else "·" for pixel in pixels))
+
+        lines.append("")
+
+        # Two pixel rows per line: upper half block, lower half block or full block
+        for y in range(0, OLED_PAGES * 8, 2):
+            line = ""
+
+            for x in range(OLED_WIDTH):
+                line += " ▀▄█"[self.oled_pixel(x, y) | (self.oled_pixel(x, y + 1) << 1)]
+
+            lines.append(line)
+
+        lines.append("")
+        lines.extend(self.output.lines)
+
+        self.changed = False
+
+        return "\n".join(lines)
+
+
+def show(mirror, screen):
+    screen.write("\x1b[H\x1b[J" + mirror.render() + "\n")
+    screen.flush()
+
+
+def live(read, mirror, screen):
+    """Redraws when something changed, at most every FRAME_PERIOD_S"""
+    last = 0.0
+    screen.write("\x1b[2J")
+
+    while True:
+        data = read()
+
+        if data is None:
+            break
+
+        baud = mirror.feed(data)
+
+        if mirror.changed and time.monotonic() - last >= FRAME_PERIOD_S:
+            show(mirror, screen)
+            last = time.monotonic()
+
+        yield baud
+
+    show(mirror, screen)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    source = parser.add_mutually_exclusive_group()
+    source.add_argument("--port", help="serial port of the Nucleo (virtual COM port)")
+    source.add_argument("--file", help="recorded stream (default: stdin)")
+    parser.add_argument(
+        "--baud", type=int, default=telemetry.DEFAULT_BAUD, help=f"initial baud rate (default: {telemetry.DEFAULT_BAUD})"
+    )
+    args = parser.parse_args()
+
+    mirror = Mirror(Log(LOG_LINES))
+
+    try:
+        if args.port:
+            import serial  # pyserial, only needed for live capture
+
+            with serial.Serial(args.port, args.baud, timeout=0.1) as connection:
+                for baud in live(lambda: connection.read(256), mirror, sys.stdout):
+                    if baud is not None:
+                        connection.baudrate = baud
+        elif args.file:
+            with open(args.file, "rb") as stream:
+                mirror.feed(stream.read())
+
+            print(mirror.render())
+        else:
+            for _ in live(lambda: sys.stdin.buffer.read1(256) or None, mirror, sys.stdout):
+                pass
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
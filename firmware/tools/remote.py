@@ -0,0 +1,231 @@
+#!/usr/bin/env python3
+"""
+Remote control of the firmware over USART2 (remote/remote.h): soak tests and input-to-frame latency measurements.
+
+The firmware has to be built with REMOTE_ENABLED=1. Every injected button event carries a tag. The firmware reports
+it back with a REMOTE_INPUT record after the first frame which followed the event. The round trip is measured on the
+host (command sent -> record received). The firmware side is split into the time in the input queue (received ->
+consumed by the game loop) and the input-to-frame latency (received -> frame pushed).
+
+Command: type (u8), payload, CRC-8 (poly 0x07, init 0x00)
+Frame:   COBS encoded command, terminated by 0x00
+
+Usage:
+    python3 tools/remote.py --port /dev/ttyACM0 --tap center --tap center --duration 600 --rate 20
+    python3 tools/remote.py --file uart.bin        (firmware side of a recorded stream, e.g. sim/scripts/remote.txt)
+"""
+
+import argparse
+import os
+import random
+import struct
+import sys
+import time
+
+import telemetry
+
+COMMAND_INPUT = 0x01  # Must match remote.h
+RECORD_REMOTE_INPUT = 0x0B
+BUTTONS = {"up": 0, "down": 1, "left": 2, "right": 3, "center": 4}  # button_t
+TAP_HOLD_S = 0.06
+
+
+def cobs_encode(data):
+    frame = bytearray()
+
+    for block in data.split(b"\x00"):
+        while len(block) >= 0xFE:
+            frame += b"\xff" + block[:0xFE]
+            block = block[0xFE:]
+
+        frame += bytes([len(block) + 1]) + block
+
+    return bytes(frame)
+
+
+def input_command(button, pressed, tag):
+    command = struct.pack("<BBBH", COMMAND_INPUT, button, int(pressed), tag)
+
+    return cobs_encode(command + bytes([telemetry.crc8(command)])) + b"\x00"
+
+
+def summary(name, values):
+    if not values:
+        return f"{name}: -"
+
+    values = sorted(values)
+    average = sum(values) / len(values)
+    p95 = values[min(len(values) - 1, (95 * len(values)) // 100)]
+
+    return (
+        f"{name}: n={len(values)} min={values[0]:.1f} avg={average:.1f} p50={values[len(values) // 2]:.1f} "
+        f"p95={p95:.1f} max={values[-1]:.1f} ms"
+    )
+
+
+class Monitor(telemetry.Decoder):
+    """Telemetry decoder which matches the REMOTE_INPUT records with the sent commands"""
+
+    def __init__(self, output):
+        super().__init__(output)
+        self.sent = {}  # Tag -> host time of the command [s]
+        self.round_trips = []
+        self.queue_times = []
+        self.frame_times = []
+        self.lost = 0
+
+    def record(self, kind, sequence, time_ms, payload):
+        if kind == RECORD_REMOTE_INPUT and len(payload) == 10:
+            tag, received, consumed = struct.unpack("<H2I", payload)
+            sent = self.sent.pop(tag, None)
+
+            self.queue_times.append(consumed - received)
+            self.frame_times.append(time_ms - received)
+
+            if sent is not None:
+                self.round_trips.append((time.monotonic() - sent) * 1000)
+
+        return super().record(kind, sequence, time_ms, payload)
+
+    def expire(self, timeout):
+        """Counts the commands without report after timeout [s] as lost"""
+        limit = time.monotonic() - timeout
+
+        for tag, sent in list(self.sent.items()):
+            if sent < limit:
+                del self.sent[tag]
+                self.lost += 1
+
+    def report(self):
+        print(summary("round trip", self.round_trips))
+        print(summary("input queue", self.queue_times))
+        print(summary("input to frame", self.frame_times))
+        print(f"lost: {self.lost} (no report within the timeout)")
+
+
+class Remote:
+    def __init__(self, connection, monitor):
+        self.connection = connection
+        self.monitor = monitor
+        self.tag = 0
+
+    def send(self, button, pressed):
+        self.tag = self.tag % 0xFFFF + 1  # 0: no report
+        self.monitor.sent[self.tag] = time.monotonic()
+        self.connection.write(input_command(button, pressed, self.tag))
+
+    def poll(self, duration):
+        """Decodes the telemetry for duration [s]"""
+        end = time.monotonic() + duration
+
+        while True:
+            baud = self.monitor.feed(self.connection.read(self.connection.in_waiting or 1))
+
+            if baud is not None:
+                self.connection.baudrate = baud  # The commands follow the baud rate of the telemetry
+
+            if time.monotonic() >= end:
+                break
+
+    def tap(self, button, pause):
+        self.send(button, True)
+        self.poll(TAP_HOLD_S)
+        self.send(button, False)
+        self.poll(pause)
+
+    def soak(self, buttons, duration, rate, window, timeout, rng):
+        """Random press/release events at rate [1/s], at most window commands without report"""
+        end = time.monotonic() + duration
+        next_send = time.monotonic()
+        held = None
+        sent = 0
+
+        while time.monotonic() < end:
+            self.poll(0)
+            self.monitor.expire(timeout)
+
+            if time.monotonic() < next_send or len(self.monitor.sent) >= window:
+                self.poll(0.001)
+                continue
+
+            if held is None:
+                held = rng.choice(buttons)
+                self.send(BUTTONS[held], True)
+            else:
+                self.send(BUTTONS[held], False)
+                held = None
+
+            sent += 1
+            next_send = max(next_send, time.monotonic()) + 1 / rate
+
+        if held is not None:
+            self.send(BUTTONS[held], False)
+            sent += 1
+
+        # Collect the outstanding reports
+        while self.monitor.sent:
+            self.poll(0.01)
+            self.monitor.expire(timeout)
+
+        print(f"sent: {sent} events")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--port", help="serial port of the Nucleo (virtual COM port)")
+    source.add_argument("--file", help="recorded telemetry stream, only the firmware side is evaluated")
+    parser.add_argument(
+        "--baud", type=int, default=telemetry.DEFAULT_BAUD, help=f"initial baud rate (default: {telemetry.DEFAULT_BAUD})"
+    )
+    parser.add_argument(
+        "--tap", action="append", default=[], choices=BUTTONS, help="tap a button before the soak test (repeatable)"
+    )
+    parser.add_argument("--pause", type=float, default=0.5, help="pause after a tap [s] (default: 0.5)")
+    parser.add_argument("--duration", type=float, default=0, help="soak test duration [s] (default: 0, no soak test)")
+    parser.add_argument("--rate", type=float, default=10, help="soak test events per second (default: 10)")
+    parser.add_argument(
+        "--buttons", default="up,down,left,right", help="buttons of the soak test (default: up,down,left,right)"
+    )
+    parser.add_argument(
+        "--window", type=int, default=8, help="max. events without report, keeps the input queue from overflowing"
+    )
+    parser.add_argument("--timeout", type=float, default=2, help="report timeout [s] (default: 2)")
+    parser.add_argument("--seed", type=int, help="random seed of the soak test")
+    parser.add_argument("--verbose", action="store_true", help="print all telemetry records")
+    args = parser.parse_args()
+
+    buttons = args.buttons.split(",")
+
+    if any(button not in BUTTONS for button in buttons):
+        parser.error(f"--buttons: choose from {', '.join(BUTTONS)}")
+
+    output = sys.stdout if args.verbose else open(os.devnull, "w")
+    monitor = Monitor(output)
+
+    try:
+        if args.file:
+            with open(args.file, "rb") as stream:
+                monitor.feed(stream.read())
+        else:
+            import serial  # pyserial
+
+            with serial.Serial(args.port, args.baud, timeout=0.001) as connection:
+                remote = Remote(connection, monitor)
+
+                for button in args.tap:
+                    remote.tap(BUTTONS[button], args.pause)
+
+                if args.duration > 0:
+                    remote.soak(buttons, args.duration, args.rate, args.window, args.timeout, random.Random(args.seed))
+                else:
+                    remote.poll(args.timeout)
+                    monitor.expire(0)
+    except KeyboardInterrupt:
+        pass
+
+    monitor.report()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,257 @@
+#!/usr/bin/env python3
+"""
+Decodes the binary telemetry stream of the firmware (telemetry/telemetry.h) into readable log lines.
+
+Frame:  COBS encoded record, terminated by 0x00
+Record: type (u8), sequence (u8), time [ms] (u32), payload, CRC-8 (poly 0x07, init 0x00)
+
+The stream is read from a serial port (needs pyserial), a file (e.g. the --uart output of the simulator) or stdin.
+When reading from a serial port, the baud rate follows the BAUD records of the firmware.
+
+Usage:
+    python3 tools/telemetry.py --port /dev/ttyACM0
+    python3 tools/telemetry.py --file uart.bin
+"""
+
+import argparse
+import struct
+import sys
+
+DEFAULT_BAUD = 115200  # CLOCK_UART_BAUD_LOW_POWER
+
+# Must match telemetry.h, profile.h and the error enums of the modules
+GAMES = {0: "snake", 1: "tictactoe", 2: "drawing"}
+WINNERS = {1: "X", 2: "O", 3: "draw"}
+SCOPES = ["game_update", "game_render", "matrix_push", "oled_update", "oled_update_async", "snake_step"]
+BUSES = ["SPI1", "I2C1"]
+ERRORS = {
+    0x01: ("clock", ["OK", "ERROR"]),
+    0x02: ("max7219", ["OK", "ERROR", "COM_ERROR", "WRONG_ADDRESS", "BUSY", "UNCHANGED"]),
+    0x03: ("ssd1306", ["OK", "I2C_ERROR"]),
+    0x04: ("storage", ["OK", "ERROR", "NOT_FOUND", "FULL", "INVALID_KEY", "NOT_INITIALIZED"]),
+}
+
+
+def crc8(data):
+    crc = 0
+
+    for byte in data:
+        crc ^= byte
+
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+
+    return crc
+
+
+def cobs_decode(frame):
+    data = bytearray()
+    index = 0
+
+    while index < len(frame):
+        code = frame[index]
+
+        if code == 0 or index + code > len(frame):
+            raise ValueError("invalid COBS code")
+
+        data += frame[index + 1 : index + code]
+        index += code
+
+        if code < 0xFF and index < len(frame):
+            data.append(0)
+
+    return bytes(data)
+
+
+def packbits_decode(data):
+    """Code 0..127: code + 1 literal bytes follow, code 129..255: the next byte repeats 257 - code times"""
+    out = bytearray()
+    index = 0
+
+    while index < len(data):
+        code = data[index]
+
+        if code < 0x80:
+            if index + 1 + code + 1 > len(data):
+                raise struct.error("truncated PackBits literal")
+
+            out += data[index + 1 : index + 2 + code]
+            index += code + 2
+        elif code > 0x80:
+            if index + 1 >= len(data):
+                raise struct.error("truncated PackBits run")
+
+            out += bytes([data[index + 1]]) * (257 - code)
+            index += 2
+        else:
+            index += 1  # No-op
+
+    return bytes(out)
+
+
+def name(table, index):
+    return table[index] if 0 <= index < len(table) else str(index)
+
+
+def event_text(event, argument, game):
+    if event == 0x01:
+        return f"game start {GAMES.get(argument, argument)}"
+    if event == 0x02:
+        return f"game exit {GAMES.get(argument, argument)}"
+    if event == 0x03 and game == 1:
+        return f"game over, winner {WINNERS.get(argument, argument)}"
+    if event == 0x03:
+        return f"game over, score {argument}"
+    if event == 0x04:
+        return "stop mode"
+    if event == 0x05:
+        return "wake-up"
+
+    return f"event {event:#04x} {argument}"
+
+
+def timing_text(count, minimum, average, maximum):
+    return f"n={count} min={minimum} avg={average} max={maximum} us"
+
+
+def record_text(kind, payload, game):
+    """Returns the text of a record and the new baud rate (BAUD record) or None"""
+    if kind == 0x01:
+        (baud,) = struct.unpack("<I", payload)
+        return f"boot, {baud} baud", None
+    if kind == 0x02:
+        (baud,) = struct.unpack("<I", payload)
+        return f"baud rate changes to {baud}", baud
+    if kind == 0x03:
+        event, argument = struct.unpack("<BH", payload)
+        return event_text(event, argument, game), None
+    if kind == 0x04:
+        source, code = struct.unpack("<BB", payload)
+        module, codes = ERRORS.get(source, (f"source {source}", []))
+        return f"ERROR {module}: {name(codes, code)}", None
+    if kind == 0x05:
+        updates, renders, late, overruns, dropped = struct.unpack("<5I", payload)
+        return (
+            f"scheduler updates={updates} renders={renders} late={late} overruns={overruns} dropped={dropped}",
+            None,
+        )
+    if kind == 0x06:
+        scope, *timing = struct.unpack("<B4I", payload)
+        return f"scope {name(SCOPES, scope)}: {timing_text(*timing)}", None
+    if kind == 0x07:
+        *timing, budget, over = struct.unpack("<6I", payload)
+        return f"frame: {timing_text(*timing)}, budget {budget} us, {over} over budget", None
+    if kind == 0x08:
+        bus, transactions, count = struct.unpack("<B2I", payload)
+        return f"bus {name(BUSES, bus)}: {transactions} transactions, {count} bytes", None
+    if kind == 0x09:
+        geometry, offset = struct.unpack("<BB", payload[:2])
+        return f"matrix {geometry & 0x0F}x{geometry >> 4}, bytes {offset}..{offset + len(payload) - 3}", None
+    if kind == 0x0A:
+        page, column = struct.unpack("<BB", payload[:2])
+        columns = len(packbits_decode(payload[2:]))
+        return f"oled page {page}, columns {column}..{column + columns - 1}", None
+    if kind == 0x0B:
+        tag, received, consumed = struct.unpack("<H2I", payload)
+        return f"remote input #{tag}: received {received / 1000:.3f} s, consumed {consumed / 1000:.3f} s", None
+
+    return f"record {kind:#04x} {payload.hex()}", None
+
+
+class Decoder:
+    def __init__(self, output):
+        self.output = output
+        self.buffer = bytearray()
+        self.sequence = None
+        self.game = None  # Running game (GAME_START event)
+
+    def feed(self, data):
+        """Decodes all complete frames, returns the last announced baud rate or None"""
+        baud = None
+        self.buffer += data
+
+        while 0 in self.buffer:
+            end = self.buffer.index(0)
+            frame = bytes(self.buffer[:end])
+            del self.buffer[: end + 1]
+
+            if frame:
+                baud = self.frame(frame) or baud
+
+        return baud
+
+    def frame(self, frame):
+        try:
+            record = cobs_decode(frame)
+        except ValueError:
+            self.output.write(f"# invalid frame {frame.hex()}\n")
+            return None
+
+        if len(record) < 7 or crc8(record[:-1]) != record[-1]:
+            self.output.write(f"# CRC error {record.hex()}\n")
+            return None
+
+        kind, sequence, time_ms = struct.unpack("<BBI", record[:6])
+
+        if self.sequence is not None and kind != 0x01:
+            lost = (sequence - self.sequence - 1) & 0xFF
+
+            if lost:
+                self.output.write(f"# {lost} record(s) lost\n")
+
+        self.sequence = sequence
+
+        if kind == 0x03 and record[6] == 0x01:
+            self.game = record[7]
+
+        return self.record(kind, sequence, time_ms, record[6:-1])
+
+    def record(self, kind, sequence, time_ms, payload):
+        """Handles a valid record, returns the announced baud rate or None"""
+        try:
+            text, baud = record_text(kind, payload, self.game)
+        except struct.error:
+            text, baud = f"record {kind:#04x} with invalid payload {payload.hex()}", None
+
+        self.output.write(f"{time_ms / 1000:10.3f} s  #{sequence:3d}  {text}\n")
+        self.output.flush()
+
+        return baud
+
+
+def read_serial(port, baud, decoder):
+    import serial  # pyserial, only needed for live capture
+
+    with serial.Serial(port, baud, timeout=0.1) as connection:
+        while True:
+            new_baud = decoder.feed(connection.read(256))
+
+            if new_baud is not None:
+                connection.baudrate = new_baud
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    source = parser.add_mutually_exclusive_group()
+    source.add_argument("--port", help="serial port of the Nucleo (virtual COM port)")
+    source.add_argument("--file", help="recorded stream (default: stdin)")
+    parser.add_argument("--baud", type=int, default=DEFAULT_BAUD, help=f"initial baud rate (default: {DEFAULT_BAUD})")
+    args = parser.parse_args()
+
+    decoder = Decoder(sys.stdout)
+
+    try:
+        if args.port:
+            read_serial(args.port, args.baud, decoder)
+        elif args.file:
+            with open(args.file, "rb") as stream:
+                decoder.feed(stream.read())
+        else:
+            while chunk := sys.stdin.buffer.read1(256):
+                decoder.feed(chunk)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()